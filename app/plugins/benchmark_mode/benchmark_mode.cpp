@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,15 +17,101 @@
 
 #include "benchmark_mode.h"
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+
+#include "platform/filesystem.h"
+#include "platform/parser.h"
 #include "platform/platform.h"
+#include "vulkan_sample.h"
 
 namespace plugins
 {
+namespace
+{
+/// Width of the buckets of the frame time histograms
+const float HISTOGRAM_BUCKET_MS = 1.0f;
+
+/// Frame times longer than the last bucket are counted in it
+const size_t HISTOGRAM_BUCKET_COUNT = 100;
+
+/**
+ * @brief Nearest-rank percentile of sorted values
+ */
+inline float percentile(const std::vector<float> &sorted_values, float percent)
+{
+	auto rank = static_cast<size_t>(std::ceil(percent / 100.0f * sorted_values.size()));
+	return sorted_values[std::max<size_t>(rank, 1) - 1];
+}
+
+/**
+ * @brief Summarizes the distribution of frame times
+ * @param times The frame times in milliseconds
+ * @return The statistics of the distribution, or null if there are no frame times
+ */
+inline nlohmann::json summarize(std::vector<float> times)
+{
+	nlohmann::json summary;
+
+	if (times.empty())
+	{
+		return summary;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	double sum = 0.0;
+	for (auto time : times)
+	{
+		sum += time;
+	}
+	double mean = sum / times.size();
+
+	double variance = 0.0;
+	for (auto time : times)
+	{
+		variance += (time - mean) * (time - mean);
+	}
+	variance /= times.size();
+
+	std::vector<uint32_t> histogram(HISTOGRAM_BUCKET_COUNT, 0);
+	for (auto time : times)
+	{
+		histogram[std::min(static_cast<size_t>(time / HISTOGRAM_BUCKET_MS), HISTOGRAM_BUCKET_COUNT - 1)]++;
+	}
+
+	// Only the buckets which are not empty, keyed by their lower bound
+	auto buckets = nlohmann::json::array();
+	for (size_t i = 0; i < histogram.size(); i++)
+	{
+		if (histogram[i] > 0)
+		{
+			buckets.push_back({{"min_ms", i * HISTOGRAM_BUCKET_MS}, {"count", histogram[i]}});
+		}
+	}
+
+	summary["count"]     = times.size();
+	summary["mean_ms"]   = mean;
+	summary["stddev_ms"] = std::sqrt(variance);
+	summary["min_ms"]    = times.front();
+	summary["p50_ms"]    = percentile(times, 50.0f);
+	summary["p90_ms"]    = percentile(times, 90.0f);
+	summary["p99_ms"]    = percentile(times, 99.0f);
+	summary["p99_9_ms"]  = percentile(times, 99.9f);
+	summary["max_ms"]    = times.back();
+	summary["histogram"] = buckets;
+
+	return summary;
+}
+}        // namespace
+
 BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
-                      "Log frame averages after running an app.",
+                      "Log frame averages after running an app, and write the distribution of frame times to the logs directory.",
                       {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
-                      {&benchmark_flag})
+                      {&benchmark_flag, &warmup_flag})
 {
 }
 
@@ -39,23 +125,144 @@ void BenchmarkMode::init(const vkb::CommandParser &parser)
 	// Whilst in benchmark mode fix the fps so that separate runs are consistently simulated
 	// This will effect the graph outputs of framerate
 	platform->force_simulation_fps(60.0f);
+
+	if (parser.contains(&warmup_flag))
+	{
+		warmup_frames = parser.as<uint32_t>(&warmup_flag);
+	}
 }
 
 void BenchmarkMode::on_update(float delta_time)
 {
 	elapsed_time += delta_time;
 	total_frames++;
+
+	// The hook receives the measured frame time, the simulation only gets the fixed one
+	Frame frame{delta_time, 0.0f, 0, false};
+
+	if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample *>(&platform->get_app()))
+	{
+		frame.configuration = vulkan_app->get_configuration().get_current_index();
+
+		// GPU times are not read back every frame, record each of them once
+		auto *stats = vulkan_app->get_stats();
+		if (stats && stats->is_available(vkb::StatIndex::gpu_time) && stats->get_last_frame(vkb::StatIndex::gpu_time) > last_gpu_frame)
+		{
+			frame.gpu_time = stats->get_last_value(vkb::StatIndex::gpu_time);
+			last_gpu_frame = stats->get_last_frame(vkb::StatIndex::gpu_time);
+		}
+	}
+
+	if (frames.empty() || frames.back().configuration != frame.configuration)
+	{
+		frames_since_change = 0;
+	}
+
+	frame.warmup = frames_since_change++ < warmup_frames;
+
+	frames.push_back(frame);
 }
 
 void BenchmarkMode::on_app_start(const std::string &app_id)
 {
-	elapsed_time = 0;
-	total_frames = 0;
+	elapsed_time   = 0;
+	total_frames   = 0;
+	last_gpu_frame = 0;
+	frames.clear();
 	LOGI("Starting Benchmark for {}", app_id);
+
+	// The GPU time is collected whatever stats the sample requested
+	if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample *>(&platform->get_app()))
+	{
+		if (auto *stats = vulkan_app->get_stats())
+		{
+			stats->request_gpu_time();
+		}
+	}
 }
 
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
 	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+
+	write_report(app_id);
+}
+
+void BenchmarkMode::write_report(const std::string &app_id) const
+{
+	std::map<uint32_t, std::vector<float>> cpu_times;
+	std::map<uint32_t, std::vector<float>> gpu_times;
+
+	for (auto &frame : frames)
+	{
+		if (frame.warmup)
+		{
+			continue;
+		}
+
+		cpu_times[frame.configuration].push_back(frame.cpu_time * 1000.0f);
+
+		if (frame.gpu_time > 0.0f)
+		{
+			gpu_times[frame.configuration].push_back(frame.gpu_time * 1000.0f);
+		}
+	}
+
+	if (cpu_times.empty())
+	{
+		LOGW("Benchmark for {} did not run past the {} warm-up frames, the report has no statistics", app_id, warmup_frames);
+	}
+
+	nlohmann::json report;
+	report["app"]             = app_id;
+	report["frames"]          = total_frames;
+	report["warmup_frames"]   = warmup_frames;
+	report["elapsed_seconds"] = elapsed_time;
+	report["configurations"]  = nlohmann::json::array();
+
+	for (auto &configuration : cpu_times)
+	{
+		auto cpu_summary = summarize(configuration.second);
+		auto gpu_summary = summarize(gpu_times[configuration.first]);
+
+		LOGI("Configuration {} frame times: p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms, p99.9 {:.2f} ms, max {:.2f} ms",
+		     configuration.first,
+		     cpu_summary["p50_ms"].get<float>(),
+		     cpu_summary["p90_ms"].get<float>(),
+		     cpu_summary["p99_ms"].get<float>(),
+		     cpu_summary["p99_9_ms"].get<float>(),
+		     cpu_summary["max_ms"].get<float>());
+
+		report["configurations"].push_back({{"configuration", configuration.first},
+		                                    {"cpu_frame_time", cpu_summary},
+		                                    {"gpu_frame_time", gpu_summary}});
+	}
+
+	auto path = vkb::fs::path::get(vkb::fs::path::Logs) + "benchmark_" + app_id;
+
+	std::ofstream json_file{path + ".json", std::ios::out | std::ios::trunc};
+	json_file << report.dump(4) << std::endl;
+
+	std::ofstream csv_file{path + ".csv", std::ios::out | std::ios::trunc};
+	csv_file << "frame,configuration,warmup,cpu_ms,gpu_ms\n";
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		auto &frame = frames[i];
+
+		csv_file << i << "," << frame.configuration << "," << (frame.warmup ? 1 : 0) << "," << frame.cpu_time * 1000.0f << ",";
+		if (frame.gpu_time > 0.0f)
+		{
+			csv_file << frame.gpu_time * 1000.0f;
+		}
+		csv_file << "\n";
+	}
+
+	if (!json_file || !csv_file)
+	{
+		LOGE("Failed to write the benchmark report to {}", path);
+		return;
+	}
+
+	LOGI("Benchmark report written to {}.json and {}.csv", path, path);
 }
 }        // namespace plugins
\ No newline at end of file
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "platform/plugins/plugin_base.h"
 
 namespace plugins
@@ -29,8 +32,13 @@ using BenchmarkModeTags = vkb::PluginBase<BenchmarkMode, vkb::tags::Passive>;
  * @brief Benchmark Mode
  * 
  * When enabled frame time statistics of a samples run will be printed to the console when an application closes. The simulation frame time (delta time) is also locked to 60FPS so that statistics can be compared more accurately across different devices.
+ *
+ * The CPU time of every frame is recorded, as well as its GPU time, measured with timestamp queries when the device supports them.
+ * Their distribution (percentiles, standard deviation and histogram) is written per configuration to the logs directory,
+ * as benchmark_<app>.json, and every frame to benchmark_<app>.csv. The first frames of a run and of each configuration
+ * are excluded from the distribution, as they include loading and cold caches.
  * 
- * Usage: vulkan_samples sample afbc --benchmark
+ * Usage: vulkan_samples sample afbc --benchmark [--benchmark-warmup 60]
  * 
  */
 class BenchmarkMode : public BenchmarkModeTags
@@ -52,9 +60,38 @@ class BenchmarkMode : public BenchmarkModeTags
 
 	vkb::FlagCommand benchmark_flag = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
 
+	vkb::FlagCommand warmup_flag = {vkb::FlagType::OneValue, "benchmark-warmup", "", "Number of frames excluded from the benchmark statistics after a start or a change of configuration (default 60)"};
+
   private:
+	struct Frame
+	{
+		/// Time between the start of this frame and of the previous one, in seconds
+		float cpu_time;
+
+		/// Time the GPU spent on a recent frame in seconds, as GPU times are read back late, or 0 if none was read back
+		float gpu_time;
+
+		uint32_t configuration;
+
+		bool warmup;
+	};
+
+	/**
+	 * @brief Logs the percentiles of the frame times, and writes their distribution and every frame to the logs directory
+	 */
+	void write_report(const std::string &app_id) const;
+
 	uint32_t total_frames{0};
 
 	float elapsed_time{0.0f};
+
+	uint32_t warmup_frames{60};
+
+	uint32_t frames_since_change{0};
+
+	/// The frame of the last GPU time recorded, as counted by the stats of the sample
+	uint64_t last_gpu_frame{0};
+
+	std::vector<Frame> frames;
 };
 }        // namespace plugins
\ No newline at end of file
@@ -968,23 +968,30 @@ VkDescriptorImageInfo ApiVulkanSample::create_descriptor(Texture &texture, VkDes
 	return descriptor;
 }
 
-Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::ContentType content_type)
+void ApiVulkanSample::upload_texture(Texture &texture, std::vector<VkBufferImageCopy> &&copy_regions)
 {
-	Texture texture{};
+	if (!upload_manager)
+	{
+		// Textures are uploaded one at a time and waited for, the larger ones get a dedicated staging buffer
+		const VkDeviceSize staging_size = 8 * 1024 * 1024;
 
-	texture.image = vkb::sg::Image::load(file, file, content_type);
-	texture.image->create_vk_image(*device);
+		upload_manager = std::make_unique<vkb::UploadManager>(*device, staging_size);
+	}
 
-	const auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+	const auto &data = texture.image->get_data();
 
-	VkCommandBuffer command_buffer = device->create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+	// The copy runs on the transfer queue when there is one, only its completion is waited for, not the whole device
+	upload_manager->upload(texture.image->get_vk_image_view(), data.data(), data.size(), std::move(copy_regions));
+	upload_manager->flush().wait();
+	upload_manager->update();
+}
 
-	vkb::core::Buffer stage_buffer{*device,
-	                               texture.image->get_data().size(),
-	                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                               VMA_MEMORY_USAGE_CPU_ONLY};
+Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::ContentType content_type)
+{
+	Texture texture{};
 
-	stage_buffer.update(texture.image->get_data());
+	texture.image = vkb::sg::Image::load(file, file, content_type);
+	texture.image->create_vk_image(*device);
 
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> bufferCopyRegions;
@@ -1006,39 +1013,7 @@ Texture ApiVulkanSample::load_texture(const std::string &file, vkb::sg::Image::C
 		bufferCopyRegions.push_back(buffer_copy_region);
 	}
 
-	VkImageSubresourceRange subresource_range = {};
-	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
-	subresource_range.layerCount              = 1;
-
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_UNDEFINED,
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(bufferCopyRegions.size()),
-	    bufferCopyRegions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	    subresource_range);
-
-	device->flush_command_buffer(command_buffer, queue.get_handle());
+	upload_texture(texture, std::move(bufferCopyRegions));
 
 	// Create a defaultsampler
 	VkSamplerCreateInfo sampler_create_info = {};
@@ -1073,17 +1048,6 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(*device, VK_IMAGE_VIEW_TYPE_2D_ARRAY);
 
-	const auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = device->create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer{*device,
-	                               texture.image->get_data().size(),
-	                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                               VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1110,39 +1074,7 @@ Texture ApiVulkanSample::load_texture_array(const std::string &file, vkb::sg::Im
 		}
 	}
 
-	VkImageSubresourceRange subresource_range = {};
-	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
-	subresource_range.layerCount              = layers;
-
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_UNDEFINED,
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	    subresource_range);
-
-	device->flush_command_buffer(command_buffer, queue.get_handle());
+	upload_texture(texture, std::move(buffer_copy_regions));
 
 	// Create a defaultsampler
 	VkSamplerCreateInfo sampler_create_info = {};
@@ -1174,17 +1106,6 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 	texture.image = vkb::sg::Image::load(file, file, content_type);
 	texture.image->create_vk_image(*device, VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 
-	const auto &queue = device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	VkCommandBuffer command_buffer = device->create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-	vkb::core::Buffer stage_buffer{*device,
-	                               texture.image->get_data().size(),
-	                               VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                               VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(texture.image->get_data());
-
 	// Setup buffer copy regions for each mip level
 	std::vector<VkBufferImageCopy> buffer_copy_regions;
 
@@ -1211,39 +1132,7 @@ Texture ApiVulkanSample::load_texture_cubemap(const std::string &file, vkb::sg::
 		}
 	}
 
-	VkImageSubresourceRange subresource_range = {};
-	subresource_range.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-	subresource_range.baseMipLevel            = 0;
-	subresource_range.levelCount              = vkb::to_u32(mipmaps.size());
-	subresource_range.layerCount              = layers;
-
-	// Image barrier for optimal image (target)
-	// Optimal image will be used as destination for the copy
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_UNDEFINED,
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    subresource_range);
-
-	// Copy mip levels from staging buffer
-	vkCmdCopyBufferToImage(
-	    command_buffer,
-	    stage_buffer.get_handle(),
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    static_cast<uint32_t>(buffer_copy_regions.size()),
-	    buffer_copy_regions.data());
-
-	// Change texture image layout to shader read after all mip levels have been copied
-	vkb::set_image_layout(
-	    command_buffer,
-	    texture.image->get_vk_image().get_handle(),
-	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-	    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	    subresource_range);
-
-	device->flush_command_buffer(command_buffer, queue.get_handle());
+	upload_texture(texture, std::move(buffer_copy_regions));
 
 	// Create a defaultsampler
 	VkSamplerCreateInfo sampler_create_info = {};
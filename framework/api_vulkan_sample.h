@@ -35,6 +35,7 @@
 #include "common/vk_initializers.h"
 #include "core/buffer.h"
 #include "core/swapchain.h"
+#include "core/upload_manager.h"
 #include "gui.h"
 #include "platform/platform.h"
 #include "rendering/render_context.h"
@@ -350,6 +351,16 @@ class ApiVulkanSample : public vkb::VulkanSample
 
 	void handle_mouse_move(int32_t x, int32_t y);
 
+	/**
+	 * @brief Uploads the data of a texture to its image and waits for the upload to complete
+	 * @param texture The texture, whose image is created
+	 * @param copy_regions The copy regions, with buffer offsets relative to the data of the image
+	 */
+	void upload_texture(Texture &texture, std::vector<VkBufferImageCopy> &&copy_regions);
+
+	/// Uploads the textures loaded by the sample, created on first use
+	std::unique_ptr<vkb::UploadManager> upload_manager;
+
 #if defined(VKB_DEBUG) || defined(VKB_VALIDATION_LAYERS)
 	/// The debug report callback
 	VkDebugReportCallbackEXT debug_report_callback{VK_NULL_HANDLE};
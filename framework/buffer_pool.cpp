@@ -24,25 +24,24 @@
 
 namespace vkb
 {
-BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
-    buffer{device, size, usage, memory_usage}
+VkDeviceSize get_buffer_offset_alignment(const Device &device, VkBufferUsageFlags usage)
 {
 	if (usage == VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minStorageBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT)
 	{
-		alignment = device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
+		return device.get_gpu().get_properties().limits.minTexelBufferOffsetAlignment;
 	}
 	else if (usage == VK_BUFFER_USAGE_INDEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_VERTEX_BUFFER_BIT || usage == VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
 	{
 		// Used to calculate the offset, required when allocating memory (its value should be power of 2)
-		alignment = 16;
+		return 16;
 	}
 	else
 	{
@@ -50,20 +49,32 @@ BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags u
 	}
 }
 
+BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    buffer{device, size, usage, memory_usage},
+    alignment{get_buffer_offset_alignment(device, usage)}
+{
+}
+
 BufferAllocation BufferBlock::allocate(const uint32_t allocate_size)
 {
 	assert(allocate_size > 0 && "Allocation size must be greater than zero");
 
-	auto aligned_offset = (offset + alignment - 1) & ~(alignment - 1);
+	VkDeviceSize current_offset = offset.load(std::memory_order_relaxed);
+	VkDeviceSize aligned_offset;
 
-	if (aligned_offset + allocate_size > buffer.get_size())
+	do
 	{
-		// No more space available from the underlying buffer, return empty allocation
-		return BufferAllocation{};
-	}
+		aligned_offset = (current_offset + alignment - 1) & ~(alignment - 1);
+
+		if (aligned_offset + allocate_size > buffer.get_size())
+		{
+			// No more space available from the underlying buffer, return empty allocation
+			return BufferAllocation{};
+		}
+
+		// Move the current offset, unless another thread moved it in the meantime
+	} while (!offset.compare_exchange_weak(current_offset, aligned_offset + allocate_size, std::memory_order_relaxed));
 
-	// Move the current offset and return an allocation
-	offset = aligned_offset + allocate_size;
 	return BufferAllocation{buffer, allocate_size, aligned_offset};
 }
 
@@ -74,7 +85,7 @@ VkDeviceSize BufferBlock::get_size() const
 
 void BufferBlock::reset()
 {
-	offset = 0;
+	offset.store(0, std::memory_order_relaxed);
 }
 
 BufferPool::BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
@@ -85,6 +96,19 @@ BufferPool::BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFla
 {
 }
 
+BufferPool::BufferPool(BufferPool &&other) :
+    device{other.device},
+    buffer_blocks{std::move(other.buffer_blocks)},
+    block_size{other.block_size},
+    usage{other.usage},
+    memory_usage{other.memory_usage},
+    active_buffer_block_count{other.active_buffer_block_count},
+    current_block{other.current_block.load()}
+{
+	other.active_buffer_block_count = 0;
+	other.current_block             = nullptr;
+}
+
 BufferBlock &BufferPool::request_buffer_block(const VkDeviceSize minimum_size, bool minimal)
 {
 	// Find the first block in the range of the inactive blocks
@@ -111,6 +135,50 @@ BufferBlock &BufferPool::request_buffer_block(const VkDeviceSize minimum_size, b
 	return *block.get();
 }
 
+BufferAllocation BufferPool::allocate(const uint32_t size, bool minimal)
+{
+	if (!minimal)
+	{
+		BufferBlock *block = current_block.load(std::memory_order_acquire);
+
+		if (block)
+		{
+			auto allocation = block->allocate(size);
+
+			if (!allocation.empty())
+			{
+				return allocation;
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> guard{block_mutex};
+
+	if (!minimal)
+	{
+		// Another thread may have switched to a new block while this one was waiting
+		BufferBlock *block = current_block.load(std::memory_order_acquire);
+
+		if (block)
+		{
+			auto allocation = block->allocate(size);
+
+			if (!allocation.empty())
+			{
+				return allocation;
+			}
+		}
+	}
+
+	auto &block = request_buffer_block(size, minimal);
+
+	auto allocation = block.allocate(size);
+
+	current_block.store(&block, std::memory_order_release);
+
+	return allocation;
+}
+
 void BufferPool::reset()
 {
 	for (auto &buffer_block : buffer_blocks)
@@ -119,6 +187,8 @@ void BufferPool::reset()
 	}
 
 	active_buffer_block_count = 0;
+
+	current_block.store(nullptr, std::memory_order_relaxed);
 }
 
 BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset) :
@@ -128,13 +198,13 @@ BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDe
 {
 }
 
-void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+void BufferAllocation::update_data(const uint8_t *data, size_t data_size, uint32_t offset)
 {
 	assert(buffer && "Invalid buffer pointer");
 
-	if (offset + data.size() <= size)
+	if (offset + data_size <= size)
 	{
-		buffer->update(data, to_u32(base_offset) + offset);
+		buffer->update(data, data_size, to_u32(base_offset) + offset);
 	}
 	else
 	{
@@ -142,6 +212,11 @@ void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
 	}
 }
 
+void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+{
+	update_data(data.data(), data.size(), offset);
+}
+
 bool BufferAllocation::empty() const
 {
 	return size == 0 || buffer == nullptr;
@@ -17,6 +17,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
 #include "common/helpers.h"
 #include "core/buffer.h"
 
@@ -24,6 +28,14 @@ namespace vkb
 {
 class Device;
 
+/**
+ * @brief Retrieves the alignment required for the offsets of sub-allocations of a buffer
+ * @param device The device the buffer is created on
+ * @param usage Usage of the buffer
+ * @return The offset alignment, a power of two
+ */
+VkDeviceSize get_buffer_offset_alignment(const Device &device, VkBufferUsageFlags usage);
+
 /**
  * @brief An allocation of vulkan memory; different buffer allocations,
  *        with different offset and size, may come from the same Vulkan buffer
@@ -43,12 +55,42 @@ class BufferAllocation
 
 	BufferAllocation &operator=(BufferAllocation &&) = default;
 
+	/**
+	 * @brief Copies a range of bytes into the allocation
+	 * @param data The data to copy from
+	 * @param size The amount of bytes to copy
+	 * @param offset The offset within the allocation to start the copying into
+	 */
+	void update_data(const uint8_t *data, size_t size, uint32_t offset = 0);
+
 	void update(const std::vector<uint8_t> &data, uint32_t offset = 0);
 
 	template <class T>
 	void update(const T &value, uint32_t offset = 0)
 	{
-		update(to_bytes(value), offset);
+		static_assert(!std::is_pointer<T>::value, "Use update_data to copy the bytes a pointer refers to");
+
+		update_data(reinterpret_cast<const uint8_t *>(&value), sizeof(T), offset);
+	}
+
+	/**
+	 * @brief Constructs an object directly in the mapped memory of the allocation
+	 * @param offset The offset within the allocation where the object is constructed
+	 * @param args The arguments forwarded to the constructor of the object
+	 */
+	template <class T, class... Args>
+	void emplace(uint32_t offset, Args &&... args)
+	{
+		assert(buffer && "Invalid buffer pointer");
+
+		if (offset + sizeof(T) <= size)
+		{
+			buffer->emplace<T>(to_u32(base_offset) + offset, std::forward<Args>(args)...);
+		}
+		else
+		{
+			LOGE("Ignore buffer allocation emplace");
+		}
 	}
 
 	bool empty() const;
@@ -69,6 +111,7 @@ class BufferAllocation
 
 /**
  * @brief Helper class which handles multiple allocation from the same underlying Vulkan buffer.
+ *        Allocations bump an atomic offset, so they can be requested from multiple threads without locking.
  */
 class BufferBlock
 {
@@ -91,7 +134,7 @@ class BufferBlock
 	VkDeviceSize alignment{0};
 
 	// Current offset, it increases on every allocation
-	VkDeviceSize offset{0};
+	std::atomic<VkDeviceSize> offset{0};
 };
 
 /**
@@ -115,8 +158,19 @@ class BufferPool
   public:
 	BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
 
+	BufferPool(BufferPool &&other);
+
 	BufferBlock &request_buffer_block(VkDeviceSize minimum_size, bool minimal = false);
 
+	/**
+	 * @brief Allocates from the current block of the pool, it can be called from multiple threads
+	 *        Only switching to a new block, when the current one is full, takes a lock
+	 * @param size Amount of memory required
+	 * @param minimal Whether the allocation should get a block of its own, with the minimum size
+	 * @return The requested allocation
+	 */
+	BufferAllocation allocate(uint32_t size, bool minimal = false);
+
 	void reset();
 
   private:
@@ -134,5 +188,11 @@ class BufferPool
 
 	/// Numbers of active blocks from the start of buffer_blocks
 	uint32_t active_buffer_block_count{0};
+
+	/// Block shared by the threads calling allocate()
+	std::atomic<BufferBlock *> current_block{nullptr};
+
+	/// Guards requesting a new block from allocate()
+	std::mutex block_mutex;
 };
 }        // namespace vkb
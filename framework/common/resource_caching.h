@@ -459,7 +459,16 @@ struct hash<vkb::PipelineState>
 	{
 		std::size_t result = 0;
 
-		vkb::hash_combine(result, pipeline_state.get_pipeline_layout().get_handle());
+		// The layout is only missing from states which are hashed without a device
+		if (pipeline_state.has_pipeline_layout())
+		{
+			vkb::hash_combine(result, pipeline_state.get_pipeline_layout().get_handle());
+
+			for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
+			{
+				vkb::hash_combine(result, shader_module->get_id());
+			}
+		}
 
 		// For graphics only
 		if (auto render_pass = pipeline_state.get_render_pass())
@@ -471,11 +480,6 @@ struct hash<vkb::PipelineState>
 
 		vkb::hash_combine(result, pipeline_state.get_subpass_index());
 
-		for (auto shader_module : pipeline_state.get_pipeline_layout().get_shader_modules())
-		{
-			vkb::hash_combine(result, shader_module->get_id());
-		}
-
 		// VkPipelineVertexInputStateCreateInfo
 		for (auto &attribute : pipeline_state.get_vertex_input_state().attributes)
 		{
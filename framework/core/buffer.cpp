@@ -17,6 +17,8 @@
 
 #include "buffer.h"
 
+#include <cstring>
+
 #include "device.h"
 
 namespace vkb
@@ -68,6 +70,12 @@ Buffer::Buffer(Device const &device, VkDeviceSize size, VkBufferUsageFlags buffe
 	}
 }
 
+Buffer::Buffer(VkBuffer handle, VkDeviceSize size) :
+    VulkanResource{handle},
+    size{size}
+{
+}
+
 Buffer::Buffer(Buffer &&other) :
     VulkanResource{other.handle, other.device},
     allocation{other.allocation},
@@ -132,9 +140,9 @@ void Buffer::unmap()
 	}
 }
 
-void Buffer::flush() const
+void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) const
 {
-	vmaFlushAllocation(device->get_memory_allocator(), allocation, 0, size);
+	vmaFlushAllocation(device->get_memory_allocator(), allocation, offset, size);
 }
 
 void Buffer::update(const std::vector<uint8_t> &data, size_t offset)
@@ -157,16 +165,17 @@ void Buffer::update(void *data, size_t size, size_t offset)
 
 void Buffer::update(const uint8_t *data, const size_t size, const size_t offset)
 {
+	// Only the updated range needs to be flushed
 	if (persistent)
 	{
-		std::copy(data, data + size, mapped_data + offset);
-		flush();
+		std::memcpy(mapped_data + offset, data, size);
+		flush(offset, size);
 	}
 	else
 	{
 		map();
-		std::copy(data, data + size, mapped_data + offset);
-		flush();
+		std::memcpy(mapped_data + offset, data, size);
+		flush(offset, size);
 		unmap();
 	}
 }
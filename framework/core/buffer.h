@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <new>
+#include <utility>
+
 #include "common/helpers.h"
 #include "common/vk_common.h"
 #include "core/vulkan_resource.h"
@@ -46,6 +49,13 @@ class Buffer : public VulkanResource<VkBuffer, VK_OBJECT_TYPE_BUFFER, const Devi
 	       VmaAllocationCreateFlags     flags                = VMA_ALLOCATION_CREATE_MAPPED_BIT,
 	       const std::vector<uint32_t> &queue_family_indices = {});
 
+	/**
+	 * @brief Wraps an existing buffer, which is neither allocated nor destroyed by this object
+	 * @param handle The buffer handle
+	 * @param size The size in bytes of the buffer
+	 */
+	Buffer(VkBuffer handle, VkDeviceSize size);
+
 	Buffer(const Buffer &) = delete;
 
 	Buffer(Buffer &&other);
@@ -90,8 +100,10 @@ class Buffer : public VulkanResource<VkBuffer, VK_OBJECT_TYPE_BUFFER, const Devi
 
 	/**
 	 * @brief Flushes memory if it is HOST_VISIBLE and not HOST_COHERENT
+	 * @param offset The offset of the range to flush
+	 * @param size The size of the range to flush, the whole buffer by default
 	 */
-	void flush() const;
+	void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const;
 
 	/**
 	 * @brief Maps vulkan memory if it isn't already mapped to an host visible address
@@ -148,6 +160,26 @@ class Buffer : public VulkanResource<VkBuffer, VK_OBJECT_TYPE_BUFFER, const Devi
 		update(reinterpret_cast<const uint8_t *>(&object), sizeof(T), offset);
 	}
 
+	/**
+	 * @brief Constructs an object directly in the mapped memory of the buffer, without any intermediate copy
+	 * @param offset The offset where the object is constructed in the mapped data
+	 * @param args The arguments forwarded to the constructor of the object
+	 */
+	template <class T, class... Args>
+	void emplace(size_t offset, Args &&... args)
+	{
+		bool was_mapped = mapped_data != nullptr;
+
+		new (map() + offset) T(std::forward<Args>(args)...);
+
+		flush(offset, sizeof(T));
+
+		if (!was_mapped)
+		{
+			unmap();
+		}
+	}
+
 	/**
 	 * @return Return the buffer's device address (note: requires that the buffer has been created with the VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT usage fla)
 	 */
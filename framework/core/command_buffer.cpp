@@ -47,6 +47,9 @@ CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel lev
 	{
 		throw VulkanException{result, "Failed to allocate command buffer"};
 	}
+
+	// Push constants are appended every draw, keep them from reallocating
+	stored_push_constants.reserve(max_push_constants_size);
 }
 
 CommandBuffer::~CommandBuffer()
@@ -107,6 +110,7 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 	stored_push_constants.clear();
+	reset_bound_buffers();
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -227,6 +231,9 @@ void CommandBuffer::next_subpass()
 void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
 {
 	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
+
+	// Executing secondary command buffers leaves the bound buffers undefined
+	reset_bound_buffers();
 }
 
 void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
@@ -235,6 +242,8 @@ void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_com
 	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
 	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
+
+	reset_bound_buffers();
 }
 
 void CommandBuffer::end_render_pass()
@@ -252,21 +261,26 @@ void CommandBuffer::set_specialization_constant(uint32_t constant_id, const std:
 	pipeline_state.set_specialization_constant(constant_id, data);
 }
 
-void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
+void CommandBuffer::push_constants(const uint8_t *data, size_t size)
 {
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
+	uint32_t push_constant_size = to_u32(stored_push_constants.size() + size);
 
 	if (push_constant_size > max_push_constants_size)
 	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
+		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, size, push_constant_size);
 		throw std::runtime_error("Push constant limit exceeded.");
 	}
 	else
 	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
+		stored_push_constants.insert(stored_push_constants.end(), data, data + size);
 	}
 }
 
+void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
+{
+	push_constants(values.data(), values.size());
+}
+
 void CommandBuffer::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
 	resource_binding_state.bind_buffer(buffer, offset, range, set, binding, array_element);
@@ -289,15 +303,47 @@ void CommandBuffer::bind_input(const core::ImageView &image_view, uint32_t set,
 
 void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets)
 {
+	// Skip the bind if the same buffers are already bound at the same offsets
+	bool already_bound = first_binding + buffers.size() <= bound_vertex_buffers.size();
+	for (size_t i = 0; already_bound && i < buffers.size(); ++i)
+	{
+		auto &bound_vertex_buffer = bound_vertex_buffers[first_binding + i];
+		already_bound             = bound_vertex_buffer.first == buffers[i].get().get_handle() && bound_vertex_buffer.second == offsets[i];
+	}
+
+	if (already_bound)
+	{
+		return;
+	}
+
 	std::vector<VkBuffer> buffer_handles(buffers.size(), VK_NULL_HANDLE);
 	std::transform(buffers.begin(), buffers.end(), buffer_handles.begin(),
 	               [](const core::Buffer &buffer) { return buffer.get_handle(); });
 	vkCmdBindVertexBuffers(get_handle(), first_binding, to_u32(buffer_handles.size()), buffer_handles.data(), offsets.data());
+
+	if (bound_vertex_buffers.size() < first_binding + buffers.size())
+	{
+		bound_vertex_buffers.resize(first_binding + buffers.size(), std::make_pair(VkBuffer{VK_NULL_HANDLE}, VkDeviceSize{0}));
+	}
+
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		bound_vertex_buffers[first_binding + i] = std::make_pair(buffer_handles[i], offsets[i]);
+	}
 }
 
 void CommandBuffer::bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type)
 {
+	if (buffer.get_handle() == bound_index_buffer && offset == bound_index_offset && index_type == bound_index_type)
+	{
+		return;
+	}
+
 	vkCmdBindIndexBuffer(get_handle(), buffer.get_handle(), offset, index_type);
+
+	bound_index_buffer = buffer.get_handle();
+	bound_index_offset = offset;
+	bound_index_type   = index_type;
 }
 
 void CommandBuffer::bind_lighting(LightingState &lighting_state, uint32_t set, uint32_t binding)
@@ -496,11 +542,13 @@ void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, cons
 void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
 {
 	VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
-	buffer_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
-	buffer_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
-	buffer_memory_barrier.buffer        = buffer.get_handle();
-	buffer_memory_barrier.offset        = offset;
-	buffer_memory_barrier.size          = size;
+	buffer_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	buffer_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	buffer_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	buffer_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+	buffer_memory_barrier.buffer              = buffer.get_handle();
+	buffer_memory_barrier.offset              = offset;
+	buffer_memory_barrier.size                = size;
 
 	VkPipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
 	VkPipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
@@ -604,6 +652,12 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 				continue;
 			}
 
+			// Skip resource sets which were reset and not bound again
+			if (resource_set.empty())
+			{
+				continue;
+			}
+
 			// Clear dirty flag for resource set
 			resource_binding_state.clear_dirty(descriptor_set_id);
 
@@ -618,101 +672,131 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			// Make descriptor set layout bound for current set
 			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
 
-			BindingMap<VkDescriptorBufferInfo> buffer_infos;
-			BindingMap<VkDescriptorImageInfo>  image_infos;
+			auto  *render_frame = command_pool.get_render_frame();
+			size_t thread_index = command_pool.get_thread_index();
 
-			std::vector<uint32_t> dynamic_offsets;
+			// Combine the hashes the resource set keeps for its bindings, so that a descriptor set
+			// already written with the same resources is found without building its infos
+			std::size_t descriptor_set_key{0};
+			hash_combine(descriptor_set_key, descriptor_set_layout.get_handle());
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : resource_set.get_resource_bindings())
-			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+			dynamic_offsets.clear();
 
-				// Check if binding exists in the pipeline layout
-				if (auto binding_info = descriptor_set_layout.get_layout_binding(binding_index))
+			for (auto &resource_binding : resource_set.get_resource_bindings())
+			{
+				if (auto binding_info = descriptor_set_layout.find_layout_binding(resource_binding.binding))
 				{
-					// Iterate over all binding resources
-					for (auto &element_it : binding_resources)
+					hash_combine(descriptor_set_key, resource_binding.hash);
+
+					if (resource_binding.info.buffer != nullptr && is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
 					{
-						auto  array_element = element_it.first;
-						auto &resource_info = element_it.second;
+						dynamic_offsets.push_back(to_u32(resource_binding.info.offset));
+					}
+					else
+					{
+						hash_combine(descriptor_set_key, resource_binding.info.offset);
+					}
+				}
+			}
 
-						// Pointer references
-						auto &buffer     = resource_info.buffer;
-						auto &sampler    = resource_info.sampler;
-						auto &image_view = resource_info.image_view;
+			// Sets updated after bind must go through the render frame to write their pending bindings
+			VkDescriptorSet descriptor_set_handle = update_after_bind ? VK_NULL_HANDLE : render_frame->find_descriptor_set(descriptor_set_key, thread_index);
 
-						// Get buffer info
-						if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
-						{
-							VkDescriptorBufferInfo buffer_info{};
+			if (descriptor_set_handle == VK_NULL_HANDLE)
+			{
+				BindingMap<VkDescriptorBufferInfo> buffer_infos;
+				BindingMap<VkDescriptorImageInfo>  image_infos;
 
-							buffer_info.buffer = resource_info.buffer->get_handle();
-							buffer_info.offset = resource_info.offset;
-							buffer_info.range  = resource_info.range;
+				// Iterate over all resource bindings
+				for (auto &resource_binding : resource_set.get_resource_bindings())
+				{
+					auto  binding_index = resource_binding.binding;
+					auto  array_element = resource_binding.array_element;
+					auto &resource_info = resource_binding.info;
 
-							if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
-							{
-								dynamic_offsets.push_back(to_u32(buffer_info.offset));
+					// Check if binding exists in the pipeline layout
+					auto binding_info = descriptor_set_layout.find_layout_binding(binding_index);
+					if (!binding_info)
+					{
+						continue;
+					}
 
-								buffer_info.offset = 0;
-							}
+					// Pointer references
+					auto &buffer     = resource_info.buffer;
+					auto &sampler    = resource_info.sampler;
+					auto &image_view = resource_info.image_view;
 
-							buffer_infos[binding_index][array_element] = buffer_info;
-						}
+					// Get buffer info
+					if (buffer != nullptr && is_buffer_descriptor_type(binding_info->descriptorType))
+					{
+						VkDescriptorBufferInfo buffer_info{};
 
-						// Get image info
-						else if (image_view != nullptr || sampler != nullptr)
+						buffer_info.buffer = resource_info.buffer->get_handle();
+						buffer_info.offset = resource_info.offset;
+						buffer_info.range  = resource_info.range;
+
+						if (is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
 						{
-							// Can be null for input attachments
-							VkDescriptorImageInfo image_info{};
-							image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
-							image_info.imageView = image_view->get_handle();
+							buffer_info.offset = 0;
+						}
+
+						buffer_infos[binding_index][array_element] = buffer_info;
+					}
 
-							if (image_view != nullptr)
+					// Get image info
+					else if (image_view != nullptr || sampler != nullptr)
+					{
+						// Can be null for input attachments
+						VkDescriptorImageInfo image_info{};
+						image_info.sampler   = sampler ? sampler->get_handle() : VK_NULL_HANDLE;
+						image_info.imageView = image_view->get_handle();
+
+						if (image_view != nullptr)
+						{
+							// Add image layout info based on descriptor type
+							switch (binding_info->descriptorType)
 							{
-								// Add image layout info based on descriptor type
-								switch (binding_info->descriptorType)
-								{
-									case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+								case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+									image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+									break;
+								case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+									if (is_depth_stencil_format(image_view->get_format()))
+									{
+										image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+									}
+									else
+									{
 										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										break;
-									case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-										if (is_depth_stencil_format(image_view->get_format()))
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-										}
-										else
-										{
-											image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-										}
-										break;
-									case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-										image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-										break;
-
-									default:
-										continue;
-								}
+									}
+									break;
+								case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+									image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+									break;
+
+								default:
+									continue;
 							}
-
-							image_infos[binding_index][array_element] = image_info;
 						}
+
+						image_infos[binding_index][array_element] = image_info;
 					}
 
 					assert((!update_after_bind ||
 					        (buffer_infos.count(binding_index) > 0 || (image_infos.count(binding_index) > 0))) &&
 					       "binding index with no buffer or image infos can't be checked for adding to bindings_to_update");
 				}
-			}
 
-			VkDescriptorSet descriptor_set_handle =
-			    command_pool.get_render_frame()->request_descriptor_set(descriptor_set_layout,
-			                                                            buffer_infos,
-			                                                            image_infos,
-			                                                            update_after_bind,
-			                                                            command_pool.get_thread_index());
+				descriptor_set_handle = render_frame->request_descriptor_set(descriptor_set_layout,
+				                                                             buffer_infos,
+				                                                             image_infos,
+				                                                             update_after_bind,
+				                                                             thread_index);
+
+				if (!update_after_bind)
+				{
+					render_frame->cache_descriptor_set(descriptor_set_key, descriptor_set_handle, thread_index);
+				}
+			}
 
 			// Bind descriptor set
 			vkCmdBindDescriptorSets(get_handle(),
@@ -754,6 +838,11 @@ const CommandBuffer::State CommandBuffer::get_state() const
 	return state;
 }
 
+CommandPool &CommandBuffer::get_command_pool() const
+{
+	return command_pool;
+}
+
 void CommandBuffer::set_update_after_bind(bool update_after_bind_)
 {
 	update_after_bind = update_after_bind_;
@@ -799,6 +888,14 @@ void CommandBuffer::write_timestamp(VkPipelineStageFlagBits pipeline_stage,
 	vkCmdWriteTimestamp(get_handle(), pipeline_stage, query_pool.get_handle(), query);
 }
 
+void CommandBuffer::reset_bound_buffers()
+{
+	bound_vertex_buffers.clear();
+	bound_index_buffer = VK_NULL_HANDLE;
+	bound_index_offset = 0;
+	bound_index_type   = VK_INDEX_TYPE_MAX_ENUM;
+}
+
 VkResult CommandBuffer::reset(ResetMode reset_mode)
 {
 	VkResult result = VK_SUCCESS;
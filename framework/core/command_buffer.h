@@ -141,25 +141,18 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 	void set_specialization_constant(uint32_t constant_id, const std::vector<uint8_t> &data);
 
 	/**
-	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
-	 * @param values The byte data to store
+	 * @brief Appends a range of bytes to the push constants flushed at the next draw or dispatch
+	 * @param data The data to copy from
+	 * @param size The amount of bytes to copy
 	 */
+	void push_constants(const uint8_t *data, size_t size);
+
 	void push_constants(const std::vector<uint8_t> &values);
 
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
 	}
 
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -232,6 +225,8 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	const State get_state() const;
 
+	CommandPool &get_command_pool() const;
+
 	void set_update_after_bind(bool update_after_bind_);
 
 	void reset_query_pool(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count);
@@ -265,6 +260,24 @@ class CommandBuffer : public core::VulkanResource<VkCommandBuffer, VK_OBJECT_TYP
 
 	std::vector<uint8_t> stored_push_constants;
 
+	/// Dynamic offsets of the descriptor set being flushed, kept to reuse its storage
+	std::vector<uint32_t> dynamic_offsets;
+
+	/// Vertex buffers and offsets bound to each binding, to skip binding them again
+	std::vector<std::pair<VkBuffer, VkDeviceSize>> bound_vertex_buffers;
+
+	/// Index buffer, offset and index type bound, to skip binding them again
+	VkBuffer bound_index_buffer{VK_NULL_HANDLE};
+
+	VkDeviceSize bound_index_offset{0};
+
+	VkIndexType bound_index_type{VK_INDEX_TYPE_MAX_ENUM};
+
+	/**
+	 * @brief Forgets the vertex and index buffers bound, as their state is not known anymore
+	 */
+	void reset_bound_buffers();
+
 	uint32_t max_push_constants_size;
 
 	VkExtent2D last_framebuffer_extent{};
@@ -18,7 +18,10 @@
 #include "debug.h"
 
 #include "core/command_buffer.h"
+#include "core/command_pool.h"
 #include "core/device.h"
+#include "rendering/render_frame.h"
+#include "stats/profiler.h"
 
 #include <glm/gtc/type_ptr.hpp>
 #include <unordered_map>
@@ -195,10 +198,23 @@ ScopedDebugLabel::ScopedDebugLabel(const CommandBuffer &command_buffer,
                                    const char *name, glm::vec4 color) :
     ScopedDebugLabel{command_buffer.get_device().get_debug_utils(), command_buffer.get_handle(), name, color}
 {
+	auto *render_frame = command_buffer.get_command_pool().get_render_frame();
+
+	if (name && *name != '\0' && render_frame && render_frame->get_profiler())
+	{
+		profiler                = render_frame->get_profiler();
+		profiled_command_buffer = &command_buffer;
+		profiler_scope          = profiler->begin_scope(command_buffer, name);
+	}
 }
 
 ScopedDebugLabel::~ScopedDebugLabel()
 {
+	if (profiler)
+	{
+		profiler->end_scope(*profiled_command_buffer, profiler_scope);
+	}
+
 	if (command_buffer != VK_NULL_HANDLE)
 	{
 		debug_utils->cmd_end_label(command_buffer);
@@ -135,12 +135,14 @@ class DummyDebugUtils final : public DebugUtils
 };
 
 class CommandBuffer;
+class Profiler;
 
 /**
  * @brief A RAII debug label.
  *        If any of EXT_debug_utils or EXT_debug_marker is available, this:
  *        - Begins a debug label / marker on construction
  *        - Ends it on destruction
+ *        If the frame of the command buffer has a profiler, the label is also profiled as a scope.
  */
 class ScopedDebugLabel final
 {
@@ -156,6 +158,10 @@ class ScopedDebugLabel final
   private:
 	const DebugUtils *debug_utils;
 	VkCommandBuffer   command_buffer;
+
+	Profiler            *profiler{nullptr};
+	const CommandBuffer *profiled_command_buffer{nullptr};
+	uint32_t             profiler_scope{~0u};
 };
 
 }        // namespace vkb
\ No newline at end of file
@@ -17,6 +17,8 @@
 
 #include "descriptor_pool.h"
 
+#include <numeric>
+
 #include "descriptor_set_layout.h"
 #include "device.h"
 
@@ -39,21 +41,21 @@ DescriptorPool::DescriptorPool(Device &                   device,
 	}
 
 	// Allocate pool sizes array
-	pool_sizes.resize(descriptor_type_counts.size());
+	set_pool_sizes.resize(descriptor_type_counts.size());
 
-	auto pool_size_it = pool_sizes.begin();
+	auto pool_size_it = set_pool_sizes.begin();
 
-	// Fill pool size for each descriptor type count multiplied by the pool size
+	// Fill pool size for each descriptor type count, pools multiply it by their number of sets
 	for (auto &it : descriptor_type_counts)
 	{
 		pool_size_it->type = it.first;
 
-		pool_size_it->descriptorCount = it.second * pool_size;
+		pool_size_it->descriptorCount = it.second;
 
 		++pool_size_it;
 	}
 
-	pool_max_sets = pool_size;
+	pool_max_sets = std::max(pool_size, 1u);
 }
 
 DescriptorPool::~DescriptorPool()
@@ -67,15 +69,45 @@ DescriptorPool::~DescriptorPool()
 
 void DescriptorPool::reset()
 {
-	// Reset all descriptor pools
-	for (auto pool : pools)
+	// The peak decays, so that the pools shrink again after a frame which allocated more sets than usual
+	peak_set_count = std::max(set_count, peak_set_count - peak_set_count / PEAK_DECAY_DIVISOR);
+
+	auto capacities = get_pool_capacities(peak_set_count);
+
+	auto capacity        = std::accumulate(pool_capacities.begin(), pool_capacities.end(), 0u);
+	auto needed_capacity = std::accumulate(capacities.begin(), capacities.end(), 0u);
+
+	// Pools are only replaced when the sets overflowed into a pool which does not fit the peak usage,
+	// or when they became much larger than needed, so that the next frames allocate from the same pools
+	if ((pools.size() > 1 && pool_capacities != capacities) || capacity > needed_capacity * 4)
+	{
+		for (auto pool : pools)
+		{
+			vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+		}
+
+		pools.clear();
+		pool_sets_count.clear();
+		pool_capacities.clear();
+
+		for (auto max_sets : capacities)
+		{
+			create_pool(max_sets);
+		}
+	}
+	else
 	{
-		vkResetDescriptorPool(device.get_handle(), pool, 0);
+		// Reset all descriptor pools
+		for (auto pool : pools)
+		{
+			vkResetDescriptorPool(device.get_handle(), pool, 0);
+		}
+
+		// Clear internal tracking of descriptor set allocations
+		std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
 	}
 
-	// Clear internal tracking of descriptor set allocations
-	std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
-	set_pool_mapping.clear();
+	set_count = 0;
 
 	// Reset the pool index from which descriptor sets are allocated
 	pool_index = 0;
@@ -119,87 +151,101 @@ VkDescriptorSet DescriptorPool::allocate()
 		return VK_NULL_HANDLE;
 	}
 
-	// Store mapping between the descriptor set and the pool
-	set_pool_mapping.emplace(handle, pool_index);
+	++set_count;
 
 	return handle;
 }
 
-VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
+uint32_t DescriptorPool::get_peak_set_count() const
 {
-	// Get the pool index of the descriptor set
-	auto it = set_pool_mapping.find(descriptor_set);
+	return std::max(peak_set_count, set_count);
+}
 
-	if (it == set_pool_mapping.end())
+std::vector<uint32_t> DescriptorPool::get_pool_capacities(uint32_t set_count) const
+{
+	// Usages beyond the largest pool are spread over as many pools of that size as needed
+	if (set_count > MAX_SETS_PER_GROWN_POOL)
 	{
-		return VK_INCOMPLETE;
+		return std::vector<uint32_t>((set_count + MAX_SETS_PER_GROWN_POOL - 1) / MAX_SETS_PER_GROWN_POOL, MAX_SETS_PER_GROWN_POOL);
 	}
 
-	auto desc_pool_index = it->second;
-
-	// Free descriptor set from the pool
-	vkFreeDescriptorSets(device.get_handle(), pools[desc_pool_index], 1, &descriptor_set);
-
-	// Remove descriptor set mapping to the pool
-	set_pool_mapping.erase(it);
-
-	// Decrement allocated set count for the pool
-	--pool_sets_count[desc_pool_index];
-
-	// Change the current pool index to use the available pool
-	pool_index = desc_pool_index;
+	uint32_t max_sets = pool_max_sets;
+	while (max_sets < set_count && max_sets < MAX_SETS_PER_GROWN_POOL)
+	{
+		max_sets *= 2;
+	}
 
-	return VK_SUCCESS;
+	return {std::max(std::min(max_sets, MAX_SETS_PER_GROWN_POOL), pool_max_sets)};
 }
 
 std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 {
-	// Create a new pool
+	// Create a new pool, twice as large as the previous one
 	if (pools.size() <= search_index)
 	{
-		VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-
-		create_info.poolSizeCount = to_u32(pool_sizes.size());
-		create_info.pPoolSizes    = pool_sizes.data();
-		create_info.maxSets       = pool_max_sets;
-
-		// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
-		create_info.flags = 0;
+		uint32_t max_sets = pool_capacities.empty() ? pool_max_sets : pool_capacities.back() * 2;
+		max_sets          = max_sets > MAX_SETS_PER_GROWN_POOL ? MAX_SETS_PER_GROWN_POOL : max_sets;
 
-		// Check descriptor set layout and enable the required flags
-		auto &binding_flags = descriptor_set_layout->get_binding_flags();
-		for (auto binding_flag : binding_flags)
+		if (!create_pool(std::max(max_sets, pool_max_sets)))
 		{
-			if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
-			{
-				create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
-			}
+			return 0;
 		}
 
-		VkDescriptorPool handle = VK_NULL_HANDLE;
+		return to_u32(pools.size() - 1);
+	}
+	else if (pool_sets_count[search_index] < pool_capacities[search_index])
+	{
+		return search_index;
+	}
+
+	// Increment pool index
+	return find_available_pool(++search_index);
+}
+
+bool DescriptorPool::create_pool(uint32_t max_sets)
+{
+	std::vector<VkDescriptorPoolSize> pool_sizes{set_pool_sizes};
+	for (auto &pool_size : pool_sizes)
+	{
+		pool_size.descriptorCount *= max_sets;
+	}
+
+	VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+
+	create_info.poolSizeCount = to_u32(pool_sizes.size());
+	create_info.pPoolSizes    = pool_sizes.data();
+	create_info.maxSets       = max_sets;
 
-		// Create the Vulkan descriptor pool
-		auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+	// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
+	create_info.flags = 0;
 
-		if (result != VK_SUCCESS)
+	// Check descriptor set layout and enable the required flags
+	auto &binding_flags = descriptor_set_layout->get_binding_flags();
+	for (auto binding_flag : binding_flags)
+	{
+		if (binding_flag & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT)
 		{
-			return 0;
+			create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
 		}
+	}
 
-		// Store internally the Vulkan handle
-		pools.push_back(handle);
+	VkDescriptorPool handle = VK_NULL_HANDLE;
 
-		// Add set count for the descriptor pool
-		pool_sets_count.push_back(0);
+	// Create the Vulkan descriptor pool
+	auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
 
-		return search_index;
-	}
-	else if (pool_sets_count[search_index] < pool_max_sets)
+	if (result != VK_SUCCESS)
 	{
-		return search_index;
+		return false;
 	}
 
-	// Increment pool index
-	return find_available_pool(++search_index);
+	// Store internally the Vulkan handle
+	pools.push_back(handle);
+
+	// Add set count and capacity for the descriptor pool
+	pool_sets_count.push_back(0);
+	pool_capacities.push_back(max_sets);
+
+	return true;
 }
 }        // namespace vkb
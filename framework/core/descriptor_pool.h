@@ -28,13 +28,25 @@ class Device;
 class DescriptorSetLayout;
 
 /**
- * @brief Manages an array of fixed size VkDescriptorPool and is able to allocate descriptor sets
+ * @brief Manages an array of VkDescriptorPool and is able to allocate descriptor sets
+ *
+ * Each new pool holds twice as many sets as the previous one. The peak number of sets allocated
+ * between two resets is tracked, so that on reset the pools are replaced by the fewest pools large
+ * enough for the following frames. The peak decays over the resets, so the pools shrink back
+ * after a spike.
  */
 class DescriptorPool
 {
   public:
+	/// Number of sets of the first pool
 	static const uint32_t MAX_SETS_PER_POOL = 16;
 
+	/// Upper bound of the number of sets of a pool
+	static const uint32_t MAX_SETS_PER_GROWN_POOL = 1024;
+
+	/// The peak number of sets loses this fraction of itself on every reset
+	static const uint32_t PEAK_DECAY_DIVISOR = 16;
+
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
 	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
@@ -57,17 +69,20 @@ class DescriptorPool
 
 	VkDescriptorSet allocate();
 
-	VkResult free(VkDescriptorSet descriptor_set);
+	/**
+	 * @return The highest number of descriptor sets allocated between two resets, decayed over the resets
+	 */
+	uint32_t get_peak_set_count() const;
 
   private:
 	Device &device;
 
 	const DescriptorSetLayout *descriptor_set_layout{nullptr};
 
-	// Descriptor pool size
-	std::vector<VkDescriptorPoolSize> pool_sizes;
+	// Number of descriptors of each type needed by a single set
+	std::vector<VkDescriptorPoolSize> set_pool_sizes;
 
-	// Number of sets to allocate for each pool
+	// Number of sets to allocate for the first pool
 	uint32_t pool_max_sets{0};
 
 	// Total descriptor pools created
@@ -76,13 +91,24 @@ class DescriptorPool
 	// Count sets for each pool
 	std::vector<uint32_t> pool_sets_count;
 
+	// Maximum number of sets of each pool
+	std::vector<uint32_t> pool_capacities;
+
 	// Current pool index to allocate descriptor set
 	uint32_t pool_index{0};
 
-	// Map between descriptor set and pool index
-	std::unordered_map<VkDescriptorSet, uint32_t> set_pool_mapping;
+	// Sets allocated since the last reset
+	uint32_t set_count{0};
+
+	uint32_t peak_set_count{0};
+
+	// The capacities of the pools which hold a number of sets
+	std::vector<uint32_t> get_pool_capacities(uint32_t set_count) const;
 
 	// Find next pool index or create new pool
 	uint32_t find_available_pool(uint32_t pool_index);
+
+	// Create a pool able to hold a number of sets and append it to the pools
+	bool create_pool(uint32_t max_sets);
 };
 }        // namespace vkb
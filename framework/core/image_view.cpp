@@ -68,6 +68,12 @@ ImageView::ImageView(Image &img, VkImageViewType view_type, VkFormat format,
 	image->get_views().emplace(this);
 }
 
+ImageView::ImageView(VkImageView handle, VkFormat format) :
+    VulkanResource{handle},
+    format{format}
+{
+}
+
 ImageView::ImageView(ImageView &&other) :
     VulkanResource{std::move(other)},
     image{other.image},
@@ -75,16 +81,19 @@ ImageView::ImageView(ImageView &&other) :
     subresource_range{other.subresource_range}
 {
 	// Remove old view from image set and add this new one
-	auto &views = image->get_views();
-	views.erase(&other);
-	views.emplace(this);
+	if (image)
+	{
+		auto &views = image->get_views();
+		views.erase(&other);
+		views.emplace(this);
+	}
 
 	other.handle = VK_NULL_HANDLE;
 }
 
 ImageView::~ImageView()
 {
-	if (handle != VK_NULL_HANDLE)
+	if (handle != VK_NULL_HANDLE && device)
 	{
 		vkDestroyImageView(device->get_handle(), handle, nullptr);
 	}
@@ -33,6 +33,13 @@ class ImageView : public VulkanResource<VkImageView, VK_OBJECT_TYPE_IMAGE_VIEW,
 	          uint32_t base_mip_level = 0, uint32_t base_array_layer = 0,
 	          uint32_t n_mip_levels = 0, uint32_t n_array_layers = 0);
 
+	/**
+	 * @brief Wraps an existing image view without a device or an image, which is not destroyed by this object
+	 * @param handle The image view handle
+	 * @param format The format of the image view
+	 */
+	ImageView(VkImageView handle, VkFormat format);
+
 	ImageView(ImageView &) = delete;
 
 	ImageView(ImageView &&other);
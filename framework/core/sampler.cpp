@@ -29,6 +29,11 @@ Sampler::Sampler(Device const &d, const VkSamplerCreateInfo &info) :
 	VK_CHECK(vkCreateSampler(device->get_handle(), &info, nullptr, &handle));
 }
 
+Sampler::Sampler(VkSampler handle) :
+    VulkanResource{handle}
+{
+}
+
 Sampler::Sampler(Sampler &&other) :
     VulkanResource{std::move(other)}
 {
@@ -36,7 +41,7 @@ Sampler::Sampler(Sampler &&other) :
 
 Sampler::~Sampler()
 {
-	if (handle != VK_NULL_HANDLE)
+	if (handle != VK_NULL_HANDLE && device)
 	{
 		vkDestroySampler(device->get_handle(), handle, nullptr);
 	}
@@ -40,6 +40,12 @@ class Sampler : public VulkanResource<VkSampler, VK_OBJECT_TYPE_SAMPLER, const D
 	 */
 	Sampler(Device const &d, const VkSamplerCreateInfo &info);
 
+	/**
+	 * @brief Wraps an existing sampler without a device, which is not destroyed by this object
+	 * @param handle The sampler handle
+	 */
+	explicit Sampler(VkSampler handle);
+
 	Sampler(const Sampler &) = delete;
 
 	Sampler(Sampler &&sampler);
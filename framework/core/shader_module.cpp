@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2022, Arm Limited and Contributors
+/* Copyright (c) 2019-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -77,6 +77,188 @@ inline std::vector<uint8_t> convert_to_bytes(std::vector<std::string> &lines)
 	return bytes;
 }
 
+namespace
+{
+/// Identifies a shader cache file, the version must be bumped whenever the serialized layout changes
+constexpr uint32_t shader_cache_magic   = 0x43565053;        // "SPVC"
+constexpr uint32_t shader_cache_version = 2;
+
+/**
+ * @brief Serializes everything that influences glslang or the reflection of a shader
+ *        The whole key is stored in the cache file and compared on load, so a collision of the file names
+ *        or an upgrade of glslang never loads the wrong SPIR-V
+ */
+std::string get_shader_cache_key(VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant)
+{
+	std::ostringstream stream;
+
+	write(stream,
+	      std::string{glslang::GetGlslVersionString()},
+	      static_cast<uint32_t>(GLSLCompiler::get_target_language()),
+	      static_cast<uint32_t>(GLSLCompiler::get_target_language_version()),
+	      static_cast<uint32_t>(stage),
+	      glsl_source,
+	      entry_point,
+	      shader_variant.get_preamble(),
+	      shader_variant.get_processes().size());
+
+	for (auto &process : shader_variant.get_processes())
+	{
+		write(stream, process);
+	}
+
+	// Runtime array sizes only affect the reflection, sort them so the key is independent of map ordering
+	std::map<std::string, size_t> runtime_array_sizes{shader_variant.get_runtime_array_sizes().begin(),
+	                                                  shader_variant.get_runtime_array_sizes().end()};
+	write(stream, runtime_array_sizes);
+
+	return stream.str();
+}
+
+inline std::string get_shader_cache_filename(const std::string &key)
+{
+	// 64-bit FNV-1a of the key, the file names are the same on every platform
+	uint64_t hash = 14695981039346656037ull;
+	for (auto c : key)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+
+	return fmt::format("vkb_shader_{:016X}.spvc", hash);
+}
+
+bool read_shader_cache(const std::string &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	auto filename = get_shader_cache_filename(key);
+
+	if (!fs::is_file(fs::path::get(fs::path::Type::Temp) + filename))
+	{
+		return false;
+	}
+
+	try
+	{
+		auto data = fs::read_temp(filename);
+
+		std::istringstream stream{std::string{data.begin(), data.end()}};
+
+		uint32_t    magic{0};
+		uint32_t    version{0};
+		std::string stored_key;
+
+		read(stream, magic, version);
+
+		if (!stream || magic != shader_cache_magic || version != shader_cache_version)
+		{
+			return false;
+		}
+
+		read(stream, stored_key);
+
+		if (!stream || stored_key != key)
+		{
+			return false;
+		}
+
+		read(stream, spirv);
+
+		std::size_t resource_count{0};
+		read(stream, resource_count);
+
+		if (!stream || spirv.empty())
+		{
+			return false;
+		}
+
+		resources.resize(resource_count);
+		for (auto &resource : resources)
+		{
+			read(stream,
+			     resource.stages,
+			     resource.type,
+			     resource.mode,
+			     resource.set,
+			     resource.binding,
+			     resource.location,
+			     resource.input_attachment_index,
+			     resource.vec_size,
+			     resource.columns,
+			     resource.array_size,
+			     resource.offset,
+			     resource.size,
+			     resource.constant_id,
+			     resource.qualifiers,
+			     resource.name);
+		}
+
+		// The trailing magic guards against files truncated by an interrupted write
+		uint32_t end_magic{0};
+		read(stream, end_magic);
+
+		return stream && end_magic == shader_cache_magic;
+	}
+	catch (std::exception &e)
+	{
+		LOGW("Failed to read shader cache file \"{}\": {}", filename, e.what());
+	}
+
+	return false;
+}
+
+void write_shader_cache(const std::string &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	std::ostringstream stream;
+
+	write(stream, shader_cache_magic, shader_cache_version, key, spirv, resources.size());
+
+	for (auto &resource : resources)
+	{
+		write(stream,
+		      resource.stages,
+		      resource.type,
+		      resource.mode,
+		      resource.set,
+		      resource.binding,
+		      resource.location,
+		      resource.input_attachment_index,
+		      resource.vec_size,
+		      resource.columns,
+		      resource.array_size,
+		      resource.offset,
+		      resource.size,
+		      resource.constant_id,
+		      resource.qualifiers,
+		      resource.name);
+	}
+
+	write(stream, shader_cache_magic);
+
+	auto str = stream.str();
+
+	try
+	{
+		fs::write_temp(std::vector<uint8_t>{str.begin(), str.end()}, get_shader_cache_filename(key));
+	}
+	catch (std::exception &e)
+	{
+		LOGW("Failed to write shader cache: {}", e.what());
+	}
+}
+}        // namespace
+
+bool ShaderModule::cache_enabled = true;
+
+void ShaderModule::set_cache_enabled(bool enabled)
+{
+	cache_enabled = enabled;
+}
+
+bool ShaderModule::is_cache_enabled()
+{
+	return cache_enabled;
+}
+
 ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant) :
     device{device},
     stage{stage},
@@ -101,23 +283,49 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 
 	// Precompile source into the final spirv bytecode
 	auto glsl_final_source = precompile_shader(source);
+	auto glsl_final_bytes  = convert_to_bytes(glsl_final_source);
 
-	// Compile the GLSL source
-	GLSLCompiler glsl_compiler;
-
-	if (!glsl_compiler.compile_to_spirv(stage, convert_to_bytes(glsl_final_source), entry_point, shader_variant, spirv, info_log))
+	// The cache key covers the source with all includes resolved, so editing an included file invalidates it
+	std::string cache_key;
+	if (cache_enabled)
 	{
-		LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
-		LOGE("{}", info_log);
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
-	}
+		cache_key = get_shader_cache_key(stage, glsl_final_bytes, entry_point, shader_variant);
 
-	SPIRVReflection spirv_reflection;
+		if (read_shader_cache(cache_key, spirv, resources))
+		{
+			LOGD("Loaded shader \"{}\" from cache", glsl_source.get_filename());
+		}
+		else
+		{
+			spirv.clear();
+			resources.clear();
+		}
+	}
 
-	// Reflect all shader resouces
-	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
+	if (spirv.empty())
 	{
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		// Compile the GLSL source
+		GLSLCompiler glsl_compiler;
+
+		if (!glsl_compiler.compile_to_spirv(stage, glsl_final_bytes, entry_point, shader_variant, spirv, info_log))
+		{
+			LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
+			LOGE("{}", info_log);
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		SPIRVReflection spirv_reflection;
+
+		// Reflect all shader resouces
+		if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
+		{
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		if (cache_enabled)
+		{
+			write_shader_cache(cache_key, spirv, resources);
+		}
 	}
 
 	// Generate a unique id, determined by source and variant
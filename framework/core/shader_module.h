@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -238,7 +238,19 @@ class ShaderModule
 	 */
 	void set_resource_mode(const std::string &resource_name, const ShaderResourceMode &resource_mode);
 
+	/**
+	 * @brief Enables or disables the on-disk cache of compiled SPIR-V and reflected resources
+	 *        Cache entries are stored in the temporary directory, keyed by the shader source,
+	 *        variant, stage and entry point, so that glslang only runs on the first launch
+	 * @param enabled Whether shader modules should be read from and written to the cache
+	 */
+	static void set_cache_enabled(bool enabled);
+
+	static bool is_cache_enabled();
+
   private:
+	static bool cache_enabled;
+
 	Device &device;
 
 	/// Shader unique id
@@ -0,0 +1,389 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "upload_manager.h"
+
+#include <limits>
+
+#include <ctpl_stl.h>
+
+#include "common/error.h"
+#include "common/logging.h"
+#include "core/device.h"
+#include "core/image_view.h"
+
+namespace vkb
+{
+namespace
+{
+/// Satisfies the offset alignment of copies to any buffer, and of copies to images of block compressed or up to 16 byte formats
+const VkDeviceSize STAGING_ALIGNMENT = 16;
+
+inline VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+}        // namespace
+
+UploadManager::UploadManager(Device &device, VkDeviceSize staging_size) :
+    device{device},
+    graphics_queue{&device.get_suitable_graphics_queue()},
+    fence_waiter{std::make_unique<ctpl::thread_pool>(1)}
+{
+	// Prefer a family without graphics, which maps to the copy engines of the device
+	uint32_t transfer_family = device.get_queue_family_index(VK_QUEUE_TRANSFER_BIT);
+
+	if (transfer_family != graphics_queue->get_family_index())
+	{
+		transfer_queue = &device.get_queue(transfer_family, 0);
+	}
+	else if (graphics_queue->get_properties().queueCount > 1)
+	{
+		transfer_queue = &device.get_queue(transfer_family, graphics_queue->get_index() == 0 ? 1 : 0);
+	}
+	else
+	{
+		transfer_queue = graphics_queue;
+	}
+
+	LOGD("Upload manager using queue {} of family {}", transfer_queue->get_index(), transfer_queue->get_family_index());
+
+	staging_buffer = std::make_unique<core::Buffer>(device, align_up(staging_size, STAGING_ALIGNMENT), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+}
+
+UploadManager::~UploadManager()
+{
+	wait_idle();
+
+	for (auto &batch : free_batches)
+	{
+		vkDestroyFence(device.get_handle(), batch->fence, nullptr);
+		vkDestroySemaphore(device.get_handle(), batch->semaphore, nullptr);
+	}
+}
+
+std::shared_future<void> UploadManager::upload(const core::Buffer &buffer, const uint8_t *data, VkDeviceSize size, VkDeviceSize offset)
+{
+	auto  staging = stage(data, size);
+	auto &batch   = get_batch();
+
+	VkBufferCopy copy_region{};
+	copy_region.srcOffset = staging.second;
+	copy_region.dstOffset = offset;
+	copy_region.size      = size;
+
+	vkCmdCopyBuffer(batch.transfer_command_buffer->get_handle(), staging.first->get_handle(), buffer.get_handle(), 1, &copy_region);
+
+	const VkPipelineStageFlags read_stages   = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+	const VkAccessFlags        read_accesses = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+	BufferMemoryBarrier memory_barrier{};
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	if (batch.graphics_command_buffer)
+	{
+		// Release the buffer to the graphics family, the acquire makes the data visible there
+		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		memory_barrier.old_queue_family = transfer_queue->get_family_index();
+		memory_barrier.new_queue_family = graphics_queue->get_family_index();
+
+		batch.transfer_command_buffer->buffer_memory_barrier(buffer, offset, size, memory_barrier);
+
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_stage_mask  = read_stages;
+		memory_barrier.dst_access_mask = read_accesses;
+
+		batch.graphics_command_buffer->buffer_memory_barrier(buffer, offset, size, memory_barrier);
+	}
+	else
+	{
+		memory_barrier.dst_stage_mask  = read_stages;
+		memory_barrier.dst_access_mask = read_accesses;
+
+		batch.transfer_command_buffer->buffer_memory_barrier(buffer, offset, size, memory_barrier);
+	}
+
+	return batch.completion;
+}
+
+std::shared_future<void> UploadManager::upload(const core::ImageView &image_view, const uint8_t *data, VkDeviceSize size, std::vector<VkBufferImageCopy> regions)
+{
+	auto  staging = stage(data, size);
+	auto &batch   = get_batch();
+
+	for (auto &region : regions)
+	{
+		region.bufferOffset += staging.second;
+	}
+
+	const VkPipelineStageFlags read_stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		batch.transfer_command_buffer->image_memory_barrier(image_view, memory_barrier);
+	}
+
+	batch.transfer_command_buffer->copy_buffer_to_image(*staging.first, image_view.get_image(), regions);
+
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+	if (batch.graphics_command_buffer)
+	{
+		// The layout transition happens once, with the release and the acquire describing it identically
+		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		memory_barrier.old_queue_family = transfer_queue->get_family_index();
+		memory_barrier.new_queue_family = graphics_queue->get_family_index();
+
+		batch.transfer_command_buffer->image_memory_barrier(image_view, memory_barrier);
+
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_stage_mask  = read_stages;
+
+		batch.graphics_command_buffer->image_memory_barrier(image_view, memory_barrier);
+	}
+	else
+	{
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_stage_mask  = read_stages;
+
+		batch.transfer_command_buffer->image_memory_barrier(image_view, memory_barrier);
+	}
+
+	return batch.completion;
+}
+
+std::shared_future<void> UploadManager::flush()
+{
+	if (!recording_batch)
+	{
+		return last_completion;
+	}
+
+	auto batch = std::move(recording_batch);
+
+	batch->transfer_command_buffer->end();
+
+	if (batch->graphics_command_buffer)
+	{
+		batch->graphics_command_buffer->end();
+
+		VkSubmitInfo transfer_submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		transfer_submit_info.commandBufferCount   = 1;
+		transfer_submit_info.pCommandBuffers      = &batch->transfer_command_buffer->get_handle();
+		transfer_submit_info.signalSemaphoreCount = 1;
+		transfer_submit_info.pSignalSemaphores    = &batch->semaphore;
+
+		VK_CHECK(transfer_queue->submit({transfer_submit_info}, VK_NULL_HANDLE));
+
+		VkPipelineStageFlags wait_stage_mask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+		VkSubmitInfo graphics_submit_info{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+		graphics_submit_info.waitSemaphoreCount = 1;
+		graphics_submit_info.pWaitSemaphores    = &batch->semaphore;
+		graphics_submit_info.pWaitDstStageMask  = &wait_stage_mask;
+		graphics_submit_info.commandBufferCount = 1;
+		graphics_submit_info.pCommandBuffers    = &batch->graphics_command_buffer->get_handle();
+
+		VK_CHECK(graphics_queue->submit({graphics_submit_info}, batch->fence));
+	}
+	else
+	{
+		VK_CHECK(transfer_queue->submit(*batch->transfer_command_buffer, batch->fence));
+	}
+
+	batch->staging_end = staging_head;
+
+	// A worker waits for the fence, so that the future gets ready without anyone polling
+	VkDevice device_handle = device.get_handle();
+	Batch   *batch_ptr     = batch.get();
+
+	batch->fence_wait = fence_waiter->push([device_handle, batch_ptr](size_t) {
+		VkResult result = vkWaitForFences(device_handle, 1, &batch_ptr->fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+		if (result != VK_SUCCESS)
+		{
+			batch_ptr->promise.set_exception(std::make_exception_ptr(VulkanException{result, "Failed to wait for upload"}));
+		}
+		else
+		{
+			batch_ptr->promise.set_value();
+		}
+	});
+
+	last_completion = batch->completion;
+
+	submitted_batches.push_back(std::move(batch));
+
+	return last_completion;
+}
+
+void UploadManager::update()
+{
+	// Batches complete in order, so the staging memory is reclaimed in order too
+	while (!submitted_batches.empty())
+	{
+		auto &batch = submitted_batches.front();
+
+		if (batch->fence_wait.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			break;
+		}
+
+		batch->fence_wait.get();
+		batch->completion.get();
+
+		staging_tail = batch->staging_end;
+
+		batch->staging_buffers.clear();
+
+		VK_CHECK(vkResetFences(device.get_handle(), 1, &batch->fence));
+
+		free_batches.push_back(std::move(batch));
+		submitted_batches.pop_front();
+	}
+}
+
+void UploadManager::wait_idle()
+{
+	flush();
+
+	for (auto &batch : submitted_batches)
+	{
+		batch->fence_wait.wait();
+	}
+
+	update();
+}
+
+bool UploadManager::has_transfer_queue() const
+{
+	return transfer_queue != graphics_queue;
+}
+
+UploadManager::Batch &UploadManager::get_batch()
+{
+	if (recording_batch)
+	{
+		return *recording_batch;
+	}
+
+	if (free_batches.empty())
+	{
+		auto batch = std::make_unique<Batch>();
+
+		batch->transfer_command_pool = std::make_unique<CommandPool>(device, transfer_queue->get_family_index());
+
+		if (transfer_queue->get_family_index() != graphics_queue->get_family_index())
+		{
+			batch->graphics_command_pool = std::make_unique<CommandPool>(device, graphics_queue->get_family_index());
+
+			VkSemaphoreCreateInfo semaphore_info{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+			VK_CHECK(vkCreateSemaphore(device.get_handle(), &semaphore_info, nullptr, &batch->semaphore));
+		}
+
+		VkFenceCreateInfo fence_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+		VK_CHECK(vkCreateFence(device.get_handle(), &fence_info, nullptr, &batch->fence));
+
+		recording_batch = std::move(batch);
+	}
+	else
+	{
+		recording_batch = std::move(free_batches.back());
+		free_batches.pop_back();
+
+		recording_batch->transfer_command_pool->reset_pool();
+
+		if (recording_batch->graphics_command_pool)
+		{
+			recording_batch->graphics_command_pool->reset_pool();
+		}
+	}
+
+	auto &batch = *recording_batch;
+
+	batch.promise    = std::promise<void>{};
+	batch.completion = batch.promise.get_future().share();
+
+	batch.transfer_command_buffer = &batch.transfer_command_pool->request_command_buffer();
+	batch.transfer_command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	if (batch.graphics_command_pool)
+	{
+		batch.graphics_command_buffer = &batch.graphics_command_pool->request_command_buffer();
+		batch.graphics_command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	}
+
+	return batch;
+}
+
+std::pair<const core::Buffer *, VkDeviceSize> UploadManager::stage(const uint8_t *data, VkDeviceSize size)
+{
+	VkDeviceSize ring_size = staging_buffer->get_size();
+
+	// Large uploads would make the ring wait for most of the previous ones
+	if (size > ring_size / 2)
+	{
+		auto &staging_buffers = get_batch().staging_buffers;
+
+		staging_buffers.emplace_back(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+		staging_buffers.back().update(data, size);
+
+		return {&staging_buffers.back(), 0};
+	}
+
+	while (true)
+	{
+		VkDeviceSize start  = align_up(staging_head, STAGING_ALIGNMENT);
+		VkDeviceSize offset = start % ring_size;
+
+		// A region cannot wrap around the end of the ring
+		if (offset + size > ring_size)
+		{
+			start += ring_size - offset;
+			offset = 0;
+		}
+
+		if (start + size - staging_tail <= ring_size)
+		{
+			staging_head = start + size;
+			staging_buffer->update(data, size, offset);
+
+			return {staging_buffer.get(), offset};
+		}
+
+		// The ring is full, submit what was recorded and wait for the oldest batch to release its staging memory
+		flush();
+
+		submitted_batches.front()->fence_wait.wait();
+		update();
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,179 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/buffer.h"
+#include "core/command_pool.h"
+
+namespace ctpl
+{
+class thread_pool;
+}        // namespace ctpl
+
+namespace vkb
+{
+class Device;
+class Queue;
+
+namespace core
+{
+class ImageView;
+}        // namespace core
+
+/**
+ * @brief Uploads data to buffers and images without stalling the device.
+ *
+ * Uploads run on a transfer-only queue when the device has one, otherwise on a second queue of the graphics
+ * family, or on the graphics queue itself. Data is staged in a ring buffer, uploads larger than half of it
+ * get a dedicated staging buffer. When uploads run on another queue family, the transfer queue releases the
+ * ownership of the resources and the graphics queue acquires it.
+ *
+ * Every upload returns a future, which is ready once the graphics queue can use the data. Uploads are submitted
+ * by flush() and the resources of the completed ones are recycled by update(). Both may submit to the graphics
+ * queue, so they have to be called from the thread which renders.
+ */
+class UploadManager
+{
+  public:
+	/**
+	 * @brief Creates an upload manager
+	 * @param device The device the data is uploaded to
+	 * @param staging_size The size of the staging ring buffer
+	 */
+	UploadManager(Device &device, VkDeviceSize staging_size = 64 * 1024 * 1024);
+
+	UploadManager(const UploadManager &) = delete;
+
+	UploadManager(UploadManager &&) = delete;
+
+	~UploadManager();
+
+	UploadManager &operator=(const UploadManager &) = delete;
+
+	UploadManager &operator=(UploadManager &&) = delete;
+
+	/**
+	 * @brief Records the upload of data to a buffer, which must have been created with VK_BUFFER_USAGE_TRANSFER_DST_BIT
+	 * @param buffer The buffer to upload to
+	 * @param data The data to upload, copied before the function returns
+	 * @param size The size of the data
+	 * @param offset The offset of the data in the buffer
+	 * @return A future ready once the upload is complete
+	 */
+	std::shared_future<void> upload(const core::Buffer &buffer, const uint8_t *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+	/**
+	 * @brief Records the upload of the mips of an image, which ends in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+	 * @param image_view A view of the levels which are uploaded, their previous content is discarded
+	 * @param data The data of the mips, copied before the function returns
+	 * @param size The size of the data
+	 * @param regions The copy regions, with buffer offsets relative to the data
+	 * @return A future ready once the upload is complete
+	 */
+	std::shared_future<void> upload(const core::ImageView &image_view, const uint8_t *data, VkDeviceSize size, std::vector<VkBufferImageCopy> regions);
+
+	/**
+	 * @brief Submits the uploads recorded since the last flush
+	 * @return A future ready once they are complete
+	 */
+	std::shared_future<void> flush();
+
+	/**
+	 * @brief Recycles the staging memory and command buffers of the uploads which completed
+	 */
+	void update();
+
+	/**
+	 * @brief Submits the uploads recorded and waits for all of them to complete
+	 */
+	void wait_idle();
+
+	/**
+	 * @return Whether uploads run on another queue than the graphics queue
+	 */
+	bool has_transfer_queue() const;
+
+  private:
+	struct Batch
+	{
+		std::unique_ptr<CommandPool> transfer_command_pool;
+
+		std::unique_ptr<CommandPool> graphics_command_pool;
+
+		CommandBuffer *transfer_command_buffer{nullptr};
+
+		/// Acquires the ownership of the resources, when the transfer queue belongs to another family
+		CommandBuffer *graphics_command_buffer{nullptr};
+
+		VkFence fence{VK_NULL_HANDLE};
+
+		VkSemaphore semaphore{VK_NULL_HANDLE};
+
+		std::promise<void> promise;
+
+		std::shared_future<void> completion;
+
+		/// Set by the thread waiting for the fence of the batch
+		std::future<void> fence_wait;
+
+		/// Head of the staging ring once the batch was recorded
+		VkDeviceSize staging_end{0};
+
+		std::vector<core::Buffer> staging_buffers;
+	};
+
+	Batch &get_batch();
+
+	/**
+	 * @brief Copies data to staging memory, submitting the batch being recorded if the staging ring is full
+	 * @return The staging buffer and the offset of the data in it
+	 */
+	std::pair<const core::Buffer *, VkDeviceSize> stage(const uint8_t *data, VkDeviceSize size);
+
+	Device &device;
+
+	const Queue *graphics_queue{nullptr};
+
+	const Queue *transfer_queue{nullptr};
+
+	std::unique_ptr<core::Buffer> staging_buffer;
+
+	/// Monotonic offsets, the physical offset is obtained modulo the size of the staging buffer
+	VkDeviceSize staging_head{0};
+
+	VkDeviceSize staging_tail{0};
+
+	std::unique_ptr<Batch> recording_batch;
+
+	std::deque<std::unique_ptr<Batch>> submitted_batches;
+
+	std::vector<std::unique_ptr<Batch>> free_batches;
+
+	std::shared_future<void> last_completion;
+
+	/// Waits for the fences of the batches, so that their futures get ready without polling
+	std::unique_ptr<ctpl::thread_pool> fence_waiter;
+};
+}        // namespace vkb
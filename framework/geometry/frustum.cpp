@@ -69,6 +69,24 @@ bool Frustum::check_sphere(glm::vec3 pos, float radius)
 	}
 	return true;
 }
+
+bool Frustum::check_aabb(const glm::vec3 &min, const glm::vec3 &max) const
+{
+	for (auto &plane : planes)
+	{
+		// Test the corner of the box which lies furthest along the plane normal
+		glm::vec3 positive_vertex{plane.x >= 0.0f ? max.x : min.x,
+		                          plane.y >= 0.0f ? max.y : min.y,
+		                          plane.z >= 0.0f ? max.z : min.z};
+
+		if (glm::dot(glm::vec3(plane), positive_vertex) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 const std::array<glm::vec4, 6> &Frustum::get_planes() const
 {
 	return planes;
@@ -57,6 +57,13 @@ class Frustum
 	 */
 	bool check_sphere(glm::vec3 pos, float radius);
 
+	/**
+	 * @brief Checks if an axis aligned bounding box is at least partially inside the Frustum
+	 * @param min The minimum corner of the box
+	 * @param max The maximum corner of the box
+	 */
+	bool check_aabb(const glm::vec3 &min, const glm::vec3 &max) const;
+
 	const std::array<glm::vec4, 6> &get_planes() const;
 
   private:
@@ -79,6 +79,30 @@ inline EShLanguage FindShaderLanguage(VkShaderStageFlagBits stage)
 			return EShLangVertex;
 	}
 }
+
+/**
+ * @brief Keeps glslang initialized for the whole process
+ *        Shaders are compiled concurrently on worker threads, finalizing glslang after a compilation
+ *        would tear down its shared state while other threads still use it
+ */
+struct GlslangProcess
+{
+	GlslangProcess()
+	{
+		glslang::InitializeProcess();
+	}
+
+	~GlslangProcess()
+	{
+		glslang::FinalizeProcess();
+	}
+};
+
+inline void initialize_glslang()
+{
+	// Initialization of function-local statics is thread-safe
+	static GlslangProcess process;
+}
 }        // namespace
 
 glslang::EShTargetLanguage        GLSLCompiler::env_target_language         = glslang::EShTargetLanguage::EShTargetNone;
@@ -96,6 +120,16 @@ void GLSLCompiler::reset_target_environment()
 	GLSLCompiler::env_target_language_version = static_cast<glslang::EShTargetLanguageVersion>(0);
 }
 
+glslang::EShTargetLanguage GLSLCompiler::get_target_language()
+{
+	return GLSLCompiler::env_target_language;
+}
+
+glslang::EShTargetLanguageVersion GLSLCompiler::get_target_language_version()
+{
+	return GLSLCompiler::env_target_language_version;
+}
+
 bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     const std::vector<uint8_t> &glsl_source,
                                     const std::string          &entry_point,
@@ -103,8 +137,7 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     std::vector<std::uint32_t> &spirv,
                                     std::string                &info_log)
 {
-	// Initialize glslang library.
-	glslang::InitializeProcess();
+	initialize_glslang();
 
 	EShMessages messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
 
@@ -168,9 +201,6 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 
 	info_log += logger.getAllMessages() + "\n";
 
-	// Shutdown glslang library.
-	glslang::FinalizeProcess();
-
 	return true;
 }
 }        // namespace vkb
@@ -53,6 +53,10 @@ class GLSLCompiler
 	 */
 	static void reset_target_environment();
 
+	static glslang::EShTargetLanguage get_target_language();
+
+	static glslang::EShTargetLanguageVersion get_target_language_version();
+
 	/**
 	 * @brief Compiles GLSL to SPIRV code
 	 * @param stage The Vulkan shader stage flag
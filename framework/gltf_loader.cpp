@@ -18,9 +18,13 @@
 
 #define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
+#include "gltf_loader_detail.h"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <queue>
+#include <tuple>
 
 #include "common/error.h"
 
@@ -35,6 +39,8 @@ VKBP_ENABLE_WARNINGS()
 #include "common/vk_common.h"
 #include "core/device.h"
 #include "core/image.h"
+#include "core/upload_manager.h"
+#include "mesh_optimizer.h"
 #include "platform/filesystem.h"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
@@ -57,6 +63,11 @@ namespace vkb
 {
 namespace
 {
+inline size_t align_up(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
 inline VkFilter find_min_filter(int min_filter)
 {
 	switch (min_filter)
@@ -116,8 +127,11 @@ inline VkSamplerAddressMode find_wrap_mode(int wrap)
 			return VK_SAMPLER_ADDRESS_MODE_REPEAT;
 	}
 };
+}        // namespace
 
-inline std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uint32_t accessorId)
+namespace detail
+{
+std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
 	auto &accessor = model->accessors[accessorId];
@@ -133,13 +147,13 @@ inline std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uin
 	return {buffer.data.begin() + startByte, buffer.data.begin() + endByte};
 };
 
-inline size_t get_attribute_size(const tinygltf::Model *model, uint32_t accessorId)
+size_t get_attribute_size(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
 	return model->accessors[accessorId].count;
 };
 
-inline size_t get_attribute_stride(const tinygltf::Model *model, uint32_t accessorId)
+size_t get_attribute_stride(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
 	auto &accessor = model->accessors[accessorId];
@@ -149,7 +163,7 @@ inline size_t get_attribute_stride(const tinygltf::Model *model, uint32_t access
 	return accessor.ByteStride(bufferView);
 };
 
-inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t accessorId)
+VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t accessorId)
 {
 	assert(accessorId < model->accessors.size());
 	auto &accessor = model->accessors[accessorId];
@@ -269,7 +283,7 @@ inline VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t acce
 	return format;
 };
 
-inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uint8_t> &src_data, uint32_t src_stride, uint32_t dst_stride)
+std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uint8_t> &src_data, uint32_t src_stride, uint32_t dst_stride)
 {
 	auto elem_count = to_u32(src_data.size()) / src_stride;
 
@@ -285,23 +299,178 @@ inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uin
 	return result;
 }
 
-inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image)
+PrimitiveData extract_primitive_data(const tinygltf::Model &model, const tinygltf::Primitive &gltf_primitive)
 {
-	// Clean up the image data, as they are copied in the staging buffer
-	image.clear_data();
+	PrimitiveData primitive;
+	primitive.attributes.reserve(gltf_primitive.attributes.size());
 
+	for (auto &gltf_attribute : gltf_primitive.attributes)
 	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		PrimitiveData::Attribute attribute;
+
+		attribute.name = gltf_attribute.first;
+		std::transform(attribute.name.begin(), attribute.name.end(), attribute.name.begin(), ::tolower);
+
+		attribute.data = get_attribute_data(&model, gltf_attribute.second);
+
+		if (attribute.name == "position")
+		{
+			assert(gltf_attribute.second < model.accessors.size());
+			primitive.vertices_count = to_u32(model.accessors[gltf_attribute.second].count);
+		}
 
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+		attribute.attribute.format = get_attribute_format(&model, gltf_attribute.second);
+		attribute.attribute.stride = to_u32(get_attribute_stride(&model, gltf_attribute.second));
+
+		primitive.attributes.push_back(std::move(attribute));
 	}
 
+	if (gltf_primitive.indices >= 0)
+	{
+		primitive.has_indices    = true;
+		primitive.vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+
+		auto format = get_attribute_format(&model, gltf_primitive.indices);
+
+		primitive.index_data = get_attribute_data(&model, gltf_primitive.indices);
+
+		switch (format)
+		{
+			case VK_FORMAT_R8_UINT:
+				// Converts uint8 data into uint16 data, still represented by a uint8 vector
+				primitive.index_data = convert_underlying_data_stride(primitive.index_data, 1, 2);
+				primitive.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R16_UINT:
+				primitive.index_type = VK_INDEX_TYPE_UINT16;
+				break;
+			case VK_FORMAT_R32_UINT:
+				primitive.index_type = VK_INDEX_TYPE_UINT32;
+				break;
+			default:
+				LOGE("gltf primitive has invalid format type");
+				break;
+		}
+	}
+	else
+	{
+		primitive.vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
+	}
+
+	return primitive;
+}
+}        // namespace detail
+
+namespace
+{
+/**
+ * @brief Reorders the triangles and vertices of an indexed triangle list, and narrows its indices when possible
+ * @return The average cache miss ratio before and after, or nothing if the primitive was left untouched
+ */
+inline std::vector<float> optimize_primitive(PrimitiveData &primitive)
+{
+	auto vertex_count = primitive.vertices_count;
+
+	if (!primitive.has_indices || primitive.vertex_indices % 3 != 0 || vertex_count == 0)
+	{
+		return {};
+	}
+
+	for (auto &attribute : primitive.attributes)
+	{
+		if (attribute.data.size() != static_cast<size_t>(vertex_count) * attribute.attribute.stride)
+		{
+			return {};
+		}
+	}
+
+	size_t index_size = primitive.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+	if (primitive.index_data.size() < static_cast<size_t>(primitive.vertex_indices) * index_size)
+	{
+		return {};
+	}
+
+	std::vector<uint32_t> indices(primitive.vertex_indices);
+
+	if (primitive.index_type == VK_INDEX_TYPE_UINT16)
+	{
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			uint16_t index;
+			std::memcpy(&index, primitive.index_data.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+			indices[i] = index;
+		}
+	}
+	else
+	{
+		std::memcpy(indices.data(), primitive.index_data.data(), indices.size() * sizeof(uint32_t));
+	}
+
+	if (std::any_of(indices.begin(), indices.end(), [vertex_count](uint32_t index) { return index >= vertex_count; }))
+	{
+		return {};
+	}
+
+	float acmr_before = compute_acmr(indices, vertex_count);
+
+	auto clusters = optimize_vertex_cache(indices, vertex_count);
+
+	auto position = std::find_if(primitive.attributes.begin(), primitive.attributes.end(), [](const PrimitiveData::Attribute &attribute) {
+		return attribute.name == "position" && (attribute.attribute.format == VK_FORMAT_R32G32B32_SFLOAT || attribute.attribute.format == VK_FORMAT_R32G32B32A32_SFLOAT);
+	});
+	if (position != primitive.attributes.end())
+	{
+		optimize_overdraw(indices, clusters, position->data.data(), position->attribute.stride);
+	}
+
+	float acmr_after = compute_acmr(indices, vertex_count);
+
+	// Renumbering the vertices does not change which ones hit the cache
+	auto remap = optimize_vertex_fetch(indices, vertex_count);
+
+	uint32_t used_vertex_count = to_u32(std::count_if(remap.begin(), remap.end(), [](uint32_t index) { return index != ~0u; }));
+
+	for (auto &attribute : primitive.attributes)
+	{
+		auto stride = attribute.attribute.stride;
+
+		std::vector<uint8_t> data(static_cast<size_t>(used_vertex_count) * stride);
+		for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+		{
+			if (remap[vertex] != ~0u)
+			{
+				std::memcpy(data.data() + static_cast<size_t>(remap[vertex]) * stride, attribute.data.data() + static_cast<size_t>(vertex) * stride, stride);
+			}
+		}
+
+		attribute.data = std::move(data);
+	}
+
+	primitive.vertices_count = used_vertex_count;
+
+	if (used_vertex_count <= std::numeric_limits<uint16_t>::max())
+	{
+		primitive.index_type = VK_INDEX_TYPE_UINT16;
+		primitive.index_data.resize(indices.size() * sizeof(uint16_t));
+
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			auto index = static_cast<uint16_t>(indices[i]);
+			std::memcpy(primitive.index_data.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+		}
+	}
+	else
+	{
+		primitive.index_type = VK_INDEX_TYPE_UINT32;
+		primitive.index_data.resize(indices.size() * sizeof(uint32_t));
+		std::memcpy(primitive.index_data.data(), indices.data(), primitive.index_data.size());
+	}
+
+	return {acmr_before, acmr_after};
+}
+
+inline void upload_image_to_gpu(UploadManager &upload_manager, sg::Image &image)
+{
 	// Create a buffer image copy for every mip level
 	auto &mipmaps = image.get_mipmaps();
 
@@ -319,20 +488,77 @@ inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &sta
 		copy_region.imageExtent               = mipmap.extent;
 	}
 
-	command_buffer.copy_buffer_to_image(staging_buffer, image.get_vk_image(), buffer_copy_regions);
+	upload_manager.upload(image.get_vk_image_view(), image.get_data().data(), image.get_data().size(), std::move(buffer_copy_regions));
+
+	// Clean up the image data, as they are copied in the staging memory
+	image.clear_data();
+}
+
+/**
+ * @brief Uploads the data of a scene through an upload manager, in batches of 64MB of which a single one is in flight
+ *        so that the staging memory of a whole scene is never alive at the same time
+ */
+class UploadBatch
+{
+  public:
+	explicit UploadBatch(UploadManager &upload_manager) :
+	    upload_manager{upload_manager}
+	{}
 
+	void upload(const std::vector<uint8_t> &data, const core::Buffer &buffer)
 	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		upload_manager.upload(buffer, data.data(), data.size());
 
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+		add(data.size());
 	}
-}
+
+	void upload(sg::Image &image)
+	{
+		auto size = image.get_data().size();
+
+		upload_image_to_gpu(upload_manager, image);
+
+		add(size);
+	}
+
+	/**
+	 * @brief Submits the uploads recorded and waits for all of them to complete
+	 */
+	void submit()
+	{
+		upload_manager.wait_idle();
+
+		previous_batch = {};
+		batch_size     = 0;
+	}
+
+  private:
+	void add(size_t size)
+	{
+		// Deal with 64MB of data at a time to keep memory footprint low
+		batch_size += size;
+		if (batch_size < 64 * 1024 * 1024)
+		{
+			return;
+		}
+
+		// The batch is recorded while the previous one is copied, then its staging memory is recycled
+		if (previous_batch.valid())
+		{
+			previous_batch.wait();
+		}
+
+		previous_batch = upload_manager.flush();
+		upload_manager.update();
+		batch_size = 0;
+	}
+
+	UploadManager &upload_manager;
+
+	std::shared_future<void> previous_batch;
+
+	size_t batch_size{0};
+};
 
 static inline bool texture_needs_srgb_colorspace(const std::string &name)
 {
@@ -348,12 +574,93 @@ static inline bool texture_needs_srgb_colorspace(const std::string &name)
 	return false;
 }
 
+bool read_whole_file(std::vector<unsigned char> *out, std::string *err, const std::string &filepath, void * /*user_data*/)
+{
+	try
+	{
+		// tinygltf owns the content of the buffers, which is copied once, straight from the mapping
+		auto file = fs::map_file(filepath);
+		out->assign(file.begin(), file.end());
+		return true;
+	}
+	catch (const std::exception &e)
+	{
+		if (err)
+		{
+			(*err) += e.what();
+			(*err) += "\n";
+		}
+		return false;
+	}
+}
+
+bool read_file_size(std::vector<unsigned char> *out, std::string *err, const std::string &filepath, void * /*user_data*/)
+{
+	try
+	{
+		// tinygltf checks the size of the buffers, which the mapping gives without reading the content
+		out->assign(fs::map_file(filepath).size(), 0);
+		return true;
+	}
+	catch (const std::exception &e)
+	{
+		if (err)
+		{
+			(*err) += e.what();
+			(*err) += "\n";
+		}
+		return false;
+	}
+}
+
+bool skip_image_data(tinygltf::Image * /*image*/, const int /*image_idx*/, std::string * /*err*/, std::string * /*warn*/,
+                     int /*req_width*/, int /*req_height*/, const unsigned char * /*bytes*/, int /*size*/, void * /*user_data*/)
+{
+	return true;
+}
+
+/**
+ * @brief Parses a glTF file from a memory mapping, the files it references are read through a mapping too
+ * @param decode_images If false, the images are left to the loader, which reads them from a scene cache
+ * @param read_files If false, only the size of the buffers and images files is read, their content is left zeroed
+ */
+inline bool load_ascii_from_file(tinygltf::TinyGLTF &gltf_loader, tinygltf::Model &model, std::string &err, std::string &warn, const std::string &gltf_file,
+                                 bool decode_images = true, bool read_files = true)
+{
+	if (!decode_images)
+	{
+		gltf_loader.SetImageLoader(&skip_image_data, nullptr);
+	}
+
+	tinygltf::FsCallbacks fs_callbacks{};
+	fs_callbacks.FileExists     = &tinygltf::FileExists;
+	fs_callbacks.ExpandFilePath = &tinygltf::ExpandFilePath;
+	fs_callbacks.ReadWholeFile  = read_files ? &read_whole_file : &read_file_size;
+	fs_callbacks.WriteWholeFile = &tinygltf::WriteWholeFile;
+	gltf_loader.SetFsCallbacks(fs_callbacks);
+
+	fs::FileData file;
+	try
+	{
+		file = fs::map_file(gltf_file);
+	}
+	catch (const std::exception &e)
+	{
+		err = e.what();
+		return false;
+	}
+
+	auto base_dir_end = gltf_file.find_last_of("/\\");
+	auto base_dir     = base_dir_end == std::string::npos ? std::string{} : gltf_file.substr(0, base_dir_end);
+
+	return gltf_loader.LoadASCIIFromString(&model, &err, &warn, reinterpret_cast<const char *>(file.data()), to_u32(file.size()), base_dir);
+}
 }        // namespace
 
 std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
     {KHR_LIGHTS_PUNCTUAL_EXTENSION, false}};
 
-GLTFLoader::GLTFLoader(Device const &device) :
+GLTFLoader::GLTFLoader(Device &device) :
     device{device}
 {
 }
@@ -367,7 +674,61 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 
 	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	scene_cache.reset();
+	scene_cache_writer.reset();
+
+	std::string cache_name;
+	uint64_t    source_hash = 0;
+
+	if (scene_cache_enabled)
+	{
+		cache_name = file_name;
+		std::replace(cache_name.begin(), cache_name.end(), '/', '_');
+		cache_name += ".vkbscene";
+
+		try
+		{
+			// Images are cached in the format they are uploaded in, which depends on the support of ASTC,
+			// and meshes in the order the optimization left them
+			uint64_t salt = device.is_image_format_supported(VK_FORMAT_ASTC_4x4_UNORM_BLOCK) ? 1 : 0;
+			salt |= mesh_optimization ? 2 : 0;
+
+			source_hash = SceneCache::hash_source(fs::map_file(gltf_file), gltf_file.substr(0, gltf_file.find_last_of('/')), salt);
+			scene_cache = SceneCache::open(cache_name, source_hash);
+		}
+		catch (const std::exception &)
+		{
+			// Loading the glTF file reports the error
+			cache_name.clear();
+		}
+	}
+
+	// The images and meshes are read from the cache when there is one, so tinygltf only needs to parse the JSON
+	bool importResult = load_ascii_from_file(gltf_loader, model, err, warn, gltf_file, !scene_cache, !scene_cache);
+
+	if (importResult && err.empty() && scene_cache && !model.animations.empty())
+	{
+		// The keyframes of the animations are read from the buffers, which the cache does not hold
+		model = tinygltf::Model{};
+		warn.clear();
+
+		tinygltf::TinyGLTF buffer_gltf_loader;
+		importResult = load_ascii_from_file(buffer_gltf_loader, model, err, warn, gltf_file, false);
+	}
+
+	if (importResult && err.empty() && scene_cache &&
+	    (scene_cache->get_image_count() != model.images.size() || scene_cache->get_mesh_count() != model.meshes.size()))
+	{
+		LOGW("Scene cache {} does not match {}, rebuilding it", cache_name, file_name);
+
+		scene_cache.reset();
+
+		model = tinygltf::Model{};
+		warn.clear();
+
+		tinygltf::TinyGLTF decoding_gltf_loader;
+		importResult = load_ascii_from_file(decoding_gltf_loader, model, err, warn, gltf_file);
+	}
 
 	if (!importResult)
 	{
@@ -388,6 +749,15 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 		LOGI("{}", warn.c_str());
 	}
 
+	if (scene_cache)
+	{
+		LOGI("Loading the images and meshes of {} from scene cache {}", file_name, cache_name);
+	}
+	else if (!cache_name.empty())
+	{
+		scene_cache_writer = std::make_unique<SceneCacheWriter>(cache_name, source_hash);
+	}
+
 	size_t pos = file_name.find_last_of('/');
 
 	model_path = file_name.substr(0, pos);
@@ -397,7 +767,37 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 		model_path.clear();
 	}
 
-	return std::make_unique<sg::Scene>(load_scene(scene_index));
+	auto scene = std::make_unique<sg::Scene>(load_scene(scene_index));
+
+	scene_cache.reset();
+	scene_cache_writer.reset();
+
+	return scene;
+}
+
+void GLTFLoader::set_packed_geometry(bool packed)
+{
+	packed_geometry = packed;
+}
+
+void GLTFLoader::set_staged_geometry_upload(bool staged)
+{
+	staged_geometry_upload = staged;
+}
+
+void GLTFLoader::set_texture_streamer(std::unique_ptr<TextureStreamer> &&streamer)
+{
+	texture_streamer = std::move(streamer);
+}
+
+void GLTFLoader::set_scene_cache(bool enabled)
+{
+	scene_cache_enabled = enabled;
+}
+
+void GLTFLoader::set_mesh_optimization(bool optimize)
+{
+	mesh_optimization = optimize;
 }
 
 std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string &file_name, uint32_t index)
@@ -409,7 +809,7 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string
 
 	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	bool importResult = load_ascii_from_file(gltf_loader, model, err, warn, gltf_file);
 
 	if (!importResult)
 	{
@@ -498,15 +898,77 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 	// Load images
 	auto thread_count = std::thread::hardware_concurrency();
 	thread_count      = thread_count == 0 ? 1 : thread_count;
+
+	// Summed over the optimized primitives, weighted by their number of triangles
+	struct
+	{
+		std::mutex mutex;
+
+		double acmr_before{0.0};
+
+		double acmr_after{0.0};
+
+		size_t triangle_count{0};
+	} mesh_statistics;
+
 	ctpl::thread_pool thread_pool(thread_count);
 
 	auto image_count = to_u32(model.images.size());
 
+	std::vector<std::unique_ptr<sg::Image>> image_components;
+
 	std::vector<std::future<std::unique_ptr<sg::Image>>> image_component_futures;
+
+	if (texture_streamer)
+	{
+		if (scene_cache_writer)
+		{
+			// Streamed images are never all in memory at once, so they cannot be cached as the scene loads
+			LOGD("Scene cache is not written when the textures are streamed");
+			scene_cache_writer.reset();
+		}
+
+		// The images are decoded and uploaded in the background, the scene holds empty images meanwhile
+		for (size_t image_index = 0; image_index < image_count; image_index++)
+		{
+			auto image = std::make_unique<sg::Image>(model.images[image_index].name);
+
+			if (scene_cache)
+			{
+				texture_streamer->add_image(*image, [cache = scene_cache, image_index]() {
+					return cache->read_image(image_index);
+				});
+			}
+			else
+			{
+				// The loader does not outlive the scene, so the decoding takes what it needs with it
+				auto gltf_image = std::make_shared<tinygltf::Image>(std::move(model.images[image_index]));
+
+				texture_streamer->add_image(*image, [&image_device = device, gltf_image, image_model_path = model_path]() {
+					return decode_image(image_device, *gltf_image, image_model_path);
+				});
+			}
+
+			image_components.push_back(std::move(image));
+		}
+
+		image_count = 0;
+	}
+
 	for (size_t image_index = 0; image_index < image_count; image_index++)
 	{
 		auto fut = thread_pool.push(
 		    [this, image_index](size_t) {
+			    // Every worker already loads an image, their rows are not spread over more threads
+			    sg::ImageWorkerScope image_worker;
+
+			    if (scene_cache)
+			    {
+				    auto image = scene_cache->read_image(image_index);
+				    image->create_vk_image(device);
+				    return image;
+			    }
+
 			    auto image = parse_image(model.images[image_index]);
 
 			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
@@ -517,59 +979,72 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		image_component_futures.push_back(std::move(fut));
 	}
 
-	std::vector<std::unique_ptr<sg::Image>> image_components;
-
-	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
-	// double the amount of memory (all the images and all the corresponding buffers).
-	// This helps keep memory footprint lower which is helpful on smaller devices.
-	size_t image_index = 0;
-	while (image_index < image_count)
+	// Extract the geometry of the meshes on the same threads, while the images are uploaded
+	std::vector<std::future<std::vector<PrimitiveData>>> mesh_futures;
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
 	{
-		std::vector<core::Buffer> transient_buffers;
-
-		auto &command_buffer = device.request_command_buffer();
+		auto fut = thread_pool.push(
+		    [this, mesh_index, &mesh_statistics](size_t) {
+			    const auto &gltf_mesh = model.meshes[mesh_index];
 
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+			    if (scene_cache)
+			    {
+				    return scene_cache->read_mesh(mesh_index);
+			    }
 
-		size_t batch_size = 0;
+			    std::vector<PrimitiveData> primitives;
+			    primitives.reserve(gltf_mesh.primitives.size());
 
-		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
-		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
+			    for (auto &gltf_primitive : gltf_mesh.primitives)
+			    {
+				    auto primitive = detail::extract_primitive_data(model, gltf_primitive);
 
-			auto &image = image_components[image_index];
+				    if (mesh_optimization && (gltf_primitive.mode == TINYGLTF_MODE_TRIANGLES || gltf_primitive.mode == -1))
+				    {
+					    auto acmr = optimize_primitive(primitive);
 
-			core::Buffer stage_buffer{device,
-			                          image->get_data().size(),
-			                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			                          VMA_MEMORY_USAGE_CPU_ONLY};
+					    if (!acmr.empty())
+					    {
+						    LOGD("Optimized '{}' mesh, primitive #{}: ACMR {:.3f} -> {:.3f}", gltf_mesh.name, primitives.size(), acmr[0], acmr[1]);
 
-			batch_size += image->get_data().size();
+						    auto triangle_count = primitive.vertex_indices / 3;
 
-			stage_buffer.update(image->get_data());
+						    std::lock_guard<std::mutex> guard{mesh_statistics.mutex};
+						    mesh_statistics.acmr_before += acmr[0] * triangle_count;
+						    mesh_statistics.acmr_after += acmr[1] * triangle_count;
+						    mesh_statistics.triangle_count += triangle_count;
+					    }
+				    }
 
-			upload_image_to_gpu(command_buffer, stage_buffer, *image);
+				    primitives.push_back(std::move(primitive));
+			    }
 
-			transient_buffers.push_back(std::move(stage_buffer));
+			    return primitives;
+		    });
 
-			image_index++;
-		}
+		mesh_futures.push_back(std::move(fut));
+	}
 
-		command_buffer.end();
+	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing double the amount of memory
+	// (all the images and all the corresponding staging buffers). This helps keep memory footprint lower which is
+	// helpful on smaller devices. The upload manager submits to its own queues, the loader only reads the device.
+	UploadManager upload_manager{device};
+	UploadBatch   upload_batch{upload_manager};
 
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+	for (size_t image_index = 0; image_index < image_count; image_index++)
+	{
+		// Wait for this image to complete loading, then stage for upload
+		image_components.push_back(image_component_futures[image_index].get());
 
-		queue.submit(command_buffer, device.request_fence());
+		auto &image = image_components[image_index];
 
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
+		// Uploading releases the data of the image, so it is cached first
+		if (scene_cache_writer)
+		{
+			scene_cache_writer->write_image(*image);
+		}
 
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+		upload_batch.upload(*image);
 	}
 
 	scene.set_components(std::move(image_components));
@@ -590,6 +1065,11 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		assert(gltf_texture.source < images.size());
 		texture->set_image(*images[gltf_texture.source]);
 
+		if (texture_streamer)
+		{
+			texture_streamer->add_texture(*texture);
+		}
+
 		if (gltf_texture.sampler >= 0 && gltf_texture.sampler < static_cast<int>(samplers.size()))
 		{
 			texture->set_sampler(*samplers[gltf_texture.sampler]);
@@ -633,6 +1113,11 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 				if (texture_needs_srgb_colorspace(gltf_value.first))
 				{
 					tex->get_image()->coerce_format_to_srgb();
+
+					if (texture_streamer)
+					{
+						texture_streamer->coerce_format_to_srgb(*tex->get_image());
+					}
 				}
 
 				material->textures[tex_name] = tex;
@@ -651,6 +1136,11 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 				if (texture_needs_srgb_colorspace(gltf_value.first))
 				{
 					tex->get_image()->coerce_format_to_srgb();
+
+					if (texture_streamer)
+					{
+						texture_streamer->coerce_format_to_srgb(*tex->get_image());
+					}
 				}
 
 				material->textures[tex_name] = tex;
@@ -660,92 +1150,121 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		scene.add_component(std::move(material));
 	}
 
+	if (texture_streamer)
+	{
+		// The streamer is updated with the scripts of the scene
+		scene.add_component(std::move(texture_streamer));
+	}
+
 	auto default_material = create_default_material();
 
 	// Load meshes
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
-	for (auto &gltf_mesh : model.meshes)
+	// Geometry is copied to device-local memory through the upload manager, unless host-visible memory was requested
+
+	auto create_geometry_buffer = [&](const std::vector<uint8_t> &data, VkBufferUsageFlags usage) {
+		if (!staged_geometry_upload)
+		{
+			core::Buffer buffer{device, data.size(), usage, VMA_MEMORY_USAGE_GPU_TO_CPU};
+			buffer.update(data);
+			return buffer;
+		}
+
+		core::Buffer buffer{device, data.size(), usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY};
+		upload_batch.upload(data, buffer);
+		return buffer;
+	};
+
+	// When the geometry is packed, the data of all the submeshes is gathered before creating the shared buffers
+	std::vector<uint8_t>                                              packed_vertex_data;
+	std::vector<uint8_t>                                              packed_index_data;
+	std::vector<std::tuple<sg::SubMesh *, std::string, VkDeviceSize>> packed_vertex_offsets;
+	std::vector<std::pair<sg::SubMesh *, VkDeviceSize>>               packed_index_offsets;
+
+	for (size_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
 	{
+		auto &gltf_mesh = model.meshes[mesh_index];
+
 		auto mesh = parse_mesh(gltf_mesh);
 
-		for (size_t i_primitive = 0; i_primitive < gltf_mesh.primitives.size(); i_primitive++)
+		// Merge the primitives in the order of the file, so that the scene does not depend on the scheduling of the threads
+		auto primitives = mesh_futures[mesh_index].get();
+
+		if (primitives.size() != gltf_mesh.primitives.size())
+		{
+			throw std::runtime_error("Scene cache does not match the primitives of mesh " + gltf_mesh.name);
+		}
+
+		if (scene_cache_writer)
+		{
+			scene_cache_writer->write_mesh(primitives);
+		}
+
+		for (size_t i_primitive = 0; i_primitive < primitives.size(); i_primitive++)
 		{
 			const auto &gltf_primitive = gltf_mesh.primitives[i_primitive];
 
+			auto &primitive = primitives[i_primitive];
+
 			auto submesh_name = fmt::format("'{}' mesh, primitive #{}", gltf_mesh.name, i_primitive);
 			auto submesh      = std::make_unique<sg::SubMesh>(std::move(submesh_name));
 
-			for (auto &attribute : gltf_primitive.attributes)
-			{
-				std::string attrib_name = attribute.first;
-				std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
+			submesh->vertices_count = primitive.vertices_count;
 
-				auto vertex_data = get_attribute_data(&model, attribute.second);
+			for (auto &attribute : primitive.attributes)
+			{
+				auto &attrib_name = attribute.name;
+				auto &vertex_data = attribute.data;
 
-				if (attrib_name == "position")
+				if (packed_geometry)
 				{
-					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
-
-				core::Buffer buffer{device,
-				                    vertex_data.size(),
-				                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-				                    VMA_MEMORY_USAGE_GPU_TO_CPU};
-				buffer.update(vertex_data);
-				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
+					// Align each attribute region so that any vertex format can be fetched from it
+					VkDeviceSize offset = align_up(packed_vertex_data.size(), 16);
+					packed_vertex_data.resize(offset);
+					packed_vertex_data.insert(packed_vertex_data.end(), vertex_data.begin(), vertex_data.end());
 
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+					packed_vertex_offsets.emplace_back(submesh.get(), attrib_name, offset);
+				}
+				else
+				{
+					auto buffer = create_geometry_buffer(vertex_data, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+					buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
+					                                  gltf_mesh.name, i_primitive, attrib_name));
 
-				sg::VertexAttribute attrib;
-				attrib.format = get_attribute_format(&model, attribute.second);
-				attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+					submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+				}
 
-				submesh->set_attribute(attrib_name, attrib);
+				submesh->set_attribute(attrib_name, attribute.attribute);
 			}
 
-			if (gltf_primitive.indices >= 0)
+			if (primitive.has_indices)
 			{
-				submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+				auto &index_data = primitive.index_data;
 
-				auto format = get_attribute_format(&model, gltf_primitive.indices);
+				submesh->vertex_indices = primitive.vertex_indices;
+				submesh->index_type     = primitive.index_type;
 
-				auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+				if (packed_geometry)
+				{
+					// Indices are addressed with firstIndex, so the region has to be aligned to the size of an index
+					VkDeviceSize offset = align_up(packed_index_data.size(), 4);
+					packed_index_data.resize(offset);
+					packed_index_data.insert(packed_index_data.end(), index_data.begin(), index_data.end());
 
-				switch (format)
+					packed_index_offsets.emplace_back(submesh.get(), offset);
+				}
+				else
 				{
-					case VK_FORMAT_R8_UINT:
-						// Converts uint8 data into uint16 data, still represented by a uint8 vector
-						index_data          = convert_underlying_data_stride(index_data, 1, 2);
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R16_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT16;
-						break;
-					case VK_FORMAT_R32_UINT:
-						submesh->index_type = VK_INDEX_TYPE_UINT32;
-						break;
-					default:
-						LOGE("gltf primitive has invalid format type");
-						break;
+					submesh->index_buffer = std::make_unique<core::Buffer>(create_geometry_buffer(index_data, VK_BUFFER_USAGE_INDEX_BUFFER_BIT));
+					submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
+					                                                  gltf_mesh.name, i_primitive));
 				}
-
-				submesh->index_buffer = std::make_unique<core::Buffer>(device,
-				                                                       index_data.size(),
-				                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-				                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
-				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
-				                                                  gltf_mesh.name, i_primitive));
-
-				submesh->index_buffer->update(index_data);
-			}
-			else
-			{
-				submesh->vertices_count = to_u32(get_attribute_size(&model, gltf_primitive.attributes.at("POSITION")));
 			}
 
+			// The data was copied to its buffer, release it before moving on to the next primitive
+			primitive = PrimitiveData{};
+
 			if (gltf_primitive.material < 0)
 			{
 				submesh->set_material(*default_material);
@@ -764,9 +1283,56 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		scene.add_component(std::move(mesh));
 	}
 
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset_pool();
+	if (!packed_vertex_data.empty())
+	{
+		auto vertex_buffer = std::make_shared<core::Buffer>(create_geometry_buffer(packed_vertex_data, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT));
+		vertex_buffer->set_debug_name(fmt::format("'{}' packed vertex buffer", model_path));
+
+		for (auto &vertex_offset : packed_vertex_offsets)
+		{
+			sg::BufferRange range;
+			range.buffer = vertex_buffer;
+			range.offset = std::get<2>(vertex_offset);
+
+			std::get<0>(vertex_offset)->packed_vertex_buffers[std::get<1>(vertex_offset)] = std::move(range);
+		}
+
+		LOGD("Packed the vertices of the scene into a {} KB buffer", packed_vertex_data.size() / 1024);
+	}
+
+	if (!packed_index_data.empty())
+	{
+		auto index_buffer = std::make_shared<core::Buffer>(create_geometry_buffer(packed_index_data, VK_BUFFER_USAGE_INDEX_BUFFER_BIT));
+		index_buffer->set_debug_name(fmt::format("'{}' packed index buffer", model_path));
+
+		for (auto &index_offset : packed_index_offsets)
+		{
+			auto *submesh = index_offset.first;
+
+			VkDeviceSize index_size = submesh->index_type == VK_INDEX_TYPE_UINT32 ? 4 : 2;
+
+			submesh->packed_index_buffer = index_buffer;
+			submesh->index_offset        = 0;
+			submesh->first_index         = to_u32(index_offset.second / index_size);
+		}
+
+		LOGD("Packed the indices of the scene into a {} KB buffer", packed_index_data.size() / 1024);
+	}
+
+	if (mesh_statistics.triangle_count > 0)
+	{
+		LOGI("Optimized {} triangles, average cache miss ratio {:.3f} -> {:.3f}",
+		     mesh_statistics.triangle_count,
+		     mesh_statistics.acmr_before / mesh_statistics.triangle_count,
+		     mesh_statistics.acmr_after / mesh_statistics.triangle_count);
+	}
+
+	upload_batch.submit();
+
+	if (scene_cache_writer)
+	{
+		scene_cache_writer->close();
+	}
 
 	scene.add_component(std::move(default_material));
 
@@ -855,7 +1421,7 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 			}
 
 			auto input_accessor      = model.accessors[gltf_sampler.input];
-			auto input_accessor_data = get_attribute_data(&model, gltf_sampler.input);
+			auto input_accessor_data = detail::get_attribute_data(&model, gltf_sampler.input);
 
 			const float *data = reinterpret_cast<const float *>(input_accessor_data.data());
 			for (size_t i = 0; i < input_accessor.count; ++i)
@@ -864,7 +1430,7 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 			}
 
 			auto output_accessor      = model.accessors[gltf_sampler.output];
-			auto output_accessor_data = get_attribute_data(&model, gltf_sampler.output);
+			auto output_accessor_data = detail::get_attribute_data(&model, gltf_sampler.output);
 
 			switch (output_accessor.type)
 			{
@@ -1029,13 +1595,8 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 {
 	auto submesh = std::make_unique<sg::SubMesh>();
 
-	std::vector<core::Buffer> transient_buffers;
-
-	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	auto &command_buffer = device.request_command_buffer();
-
-	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	// The upload manager submits to its own queues, the loader only reads the device
+	UploadManager upload_manager{device};
 
 	assert(index < model.meshes.size());
 	auto &gltf_mesh = model.meshes[index];
@@ -1101,31 +1662,22 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 		vertex_data.push_back(vert);
 	}
 
-	core::Buffer stage_buffer{device,
-	                          vertex_data.size() * sizeof(Vertex),
-	                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-	                          VMA_MEMORY_USAGE_CPU_ONLY};
-
-	stage_buffer.update(vertex_data.data(), vertex_data.size() * sizeof(Vertex));
-
 	core::Buffer buffer{device,
 	                    vertex_data.size() * sizeof(Vertex),
 	                    VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 	                    VMA_MEMORY_USAGE_GPU_ONLY};
 
-	command_buffer.copy_buffer(stage_buffer, buffer, vertex_data.size() * sizeof(Vertex));
+	upload_manager.upload(buffer, reinterpret_cast<const uint8_t *>(vertex_data.data()), vertex_data.size() * sizeof(Vertex));
 
 	auto pair = std::make_pair("vertex_buffer", std::move(buffer));
 	submesh->vertex_buffers.insert(std::move(pair));
 
-	transient_buffers.push_back(std::move(stage_buffer));
-
 	if (gltf_primitive.indices >= 0)
 	{
-		submesh->vertex_indices = to_u32(get_attribute_size(&model, gltf_primitive.indices));
+		submesh->vertex_indices = to_u32(detail::get_attribute_size(&model, gltf_primitive.indices));
 
-		auto format     = get_attribute_format(&model, gltf_primitive.indices);
-		auto index_data = get_attribute_data(&model, gltf_primitive.indices);
+		auto format     = detail::get_attribute_format(&model, gltf_primitive.indices);
+		auto index_data = detail::get_attribute_data(&model, gltf_primitive.indices);
 
 		switch (format)
 		{
@@ -1136,12 +1688,12 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 			}
 			case VK_FORMAT_R16_UINT:
 			{
-				index_data = convert_underlying_data_stride(index_data, 2, 4);
+				index_data = detail::convert_underlying_data_stride(index_data, 2, 4);
 				break;
 			}
 			case VK_FORMAT_R8_UINT:
 			{
-				index_data = convert_underlying_data_stride(index_data, 1, 4);
+				index_data = detail::convert_underlying_data_stride(index_data, 1, 4);
 				break;
 			}
 			default:
@@ -1153,30 +1705,16 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index)
 		// Always do uint32
 		submesh->index_type = VK_INDEX_TYPE_UINT32;
 
-		core::Buffer stage_buffer{device,
-		                          index_data.size(),
-		                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-		                          VMA_MEMORY_USAGE_CPU_ONLY};
-
-		stage_buffer.update(index_data);
-
 		submesh->index_buffer = std::make_unique<core::Buffer>(device,
 		                                                       index_data.size(),
 		                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
 		                                                       VMA_MEMORY_USAGE_GPU_ONLY);
 
-		command_buffer.copy_buffer(stage_buffer, *submesh->index_buffer, index_data.size());
-
-		transient_buffers.push_back(std::move(stage_buffer));
+		upload_manager.upload(*submesh->index_buffer, index_data.data(), index_data.size());
 	}
 
-	command_buffer.end();
-
-	queue.submit(command_buffer, device.request_fence());
-
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset_pool();
+	// Only the copies of the model are waited for, not the whole device
+	upload_manager.wait_idle();
 
 	return std::move(submesh);
 }
@@ -1312,6 +1850,15 @@ std::unique_ptr<sg::PBRMaterial> GLTFLoader::parse_material(const tinygltf::Mate
 }
 
 std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image) const
+{
+	auto image = decode_image(device, gltf_image, model_path);
+
+	image->create_vk_image(device);
+
+	return image;
+}
+
+std::unique_ptr<sg::Image> GLTFLoader::decode_image(const Device &device, tinygltf::Image &gltf_image, const std::string &model_path)
 {
 	std::unique_ptr<sg::Image> image{nullptr};
 
@@ -1340,13 +1887,18 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 		if (!device.is_image_format_supported(image->get_format()))
 		{
 			LOGW("ASTC not supported: decoding {}", image->get_name());
-			image = std::make_unique<sg::Astc>(*image);
-			image->generate_mipmaps();
+
+			// Decode the mips of the file when it has some, rather than regenerating them from mip #0
+			bool has_mipmaps = image->get_mipmaps().size() > 1;
+
+			image = std::make_unique<sg::Astc>(*image, has_mipmaps);
+			if (!has_mipmaps)
+			{
+				image->generate_mipmaps();
+			}
 		}
 	}
 
-	image->create_vk_image(device);
-
 	return image;
 }
 
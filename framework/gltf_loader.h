@@ -26,6 +26,8 @@
 #define TINYGLTF_NO_EXTERNAL_IMAGE
 #include <tiny_gltf.h>
 
+#include "scene_cache.h"
+#include "texture_streamer.h"
 #include "timer.h"
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
@@ -69,7 +71,7 @@ struct TypeCast
 class GLTFLoader
 {
   public:
-	GLTFLoader(Device const &device);
+	GLTFLoader(Device &device);
 
 	virtual ~GLTFLoader() = default;
 
@@ -81,6 +83,42 @@ class GLTFLoader
 	 */
 	std::unique_ptr<sg::SubMesh> read_model_from_file(const std::string &file_name, uint32_t index);
 
+	/**
+	 * @brief Packs the vertices and indices of all the meshes of a scene into two shared buffers,
+	 *        so that consecutive draws do not need to bind new buffers
+	 * @param packed Whether read_scene_from_file packs the geometry of the scene
+	 */
+	void set_packed_geometry(bool packed);
+
+	/**
+	 * @brief Selects the memory the geometry of a scene is stored in
+	 * @param staged If true (default), vertices and indices are copied to device-local memory through staging buffers,
+	 *               otherwise they are written directly to host-visible memory, which suits unified memory devices
+	 *               and allows reading the geometry back on the CPU
+	 */
+	void set_staged_geometry_upload(bool staged);
+
+	/**
+	 * @brief Streams the images of the scene instead of loading them before read_scene_from_file returns
+	 * @param streamer The streamer the images are added to, it is moved to the scene with them
+	 */
+	void set_texture_streamer(std::unique_ptr<TextureStreamer> &&streamer);
+
+	/**
+	 * @brief Keeps the decoded images and the geometry of the scenes in a cache in the temporary directory,
+	 *        so that loading a scene again skips decoding them
+	 * @param enabled Whether read_scene_from_file uses and writes the cache, false by default
+	 */
+	void set_scene_cache(bool enabled);
+
+	/**
+	 * @brief Reorders the indexed triangle lists of a scene as they are imported: triangles for the post-transform
+	 *        vertex cache then for overdraw, vertices in the order they are fetched, and indices narrowed to 16 bits
+	 *        when the vertices allow it
+	 * @param optimize Whether read_scene_from_file optimizes the meshes, false by default
+	 */
+	void set_mesh_optimization(bool optimize);
+
   protected:
 	virtual std::unique_ptr<sg::Node> parse_node(const tinygltf::Node &gltf_node, size_t index) const;
 
@@ -92,6 +130,12 @@ class GLTFLoader
 
 	virtual std::unique_ptr<sg::Image> parse_image(tinygltf::Image &gltf_image) const;
 
+	/**
+	 * @brief Loads an image and decodes it if its format is not supported, without creating its Vulkan image
+	 *        It does not depend on the loader, so that images can be decoded after the loader is gone
+	 */
+	static std::unique_ptr<sg::Image> decode_image(const Device &device, tinygltf::Image &gltf_image, const std::string &model_path);
+
 	virtual std::unique_ptr<sg::Sampler> parse_sampler(const tinygltf::Sampler &gltf_sampler) const;
 
 	virtual std::unique_ptr<sg::Texture> parse_texture(const tinygltf::Texture &gltf_texture) const;
@@ -122,12 +166,28 @@ class GLTFLoader
 	 */
 	tinygltf::Value *get_extension(tinygltf::ExtensionMap &tinygltf_extensions, const std::string &extension);
 
-	Device const &device;
+	Device &device;
 
 	tinygltf::Model model;
 
 	std::string model_path;
 
+	bool packed_geometry{false};
+
+	bool staged_geometry_upload{true};
+
+	std::unique_ptr<TextureStreamer> texture_streamer;
+
+	bool mesh_optimization{false};
+
+	bool scene_cache_enabled{false};
+
+	/// The cache of the scene being loaded, if it is valid
+	std::shared_ptr<const SceneCache> scene_cache;
+
+	/// Writes the cache of the scene being loaded, when there was no valid one
+	std::unique_ptr<SceneCacheWriter> scene_cache_writer;
+
 	/// The extensions that the GLTFLoader can load mapped to whether they should be enabled or not
 	static std::unordered_map<std::string, bool> supported_extensions;
 
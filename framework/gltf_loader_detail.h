@@ -0,0 +1,68 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "gltf_loader.h"
+
+namespace vkb
+{
+/**
+ * @brief Accessor helpers of the glTF loader, which are not part of its interface
+ *        They are only exposed to the loader and to the framework benchmarks.
+ */
+namespace detail
+{
+/**
+ * @brief Copies the elements of an accessor out of its buffer, keeping the stride of its buffer view
+ */
+std::vector<uint8_t> get_attribute_data(const tinygltf::Model *model, uint32_t accessorId);
+
+/**
+ * @return The number of elements of an accessor
+ */
+size_t get_attribute_size(const tinygltf::Model *model, uint32_t accessorId);
+
+/**
+ * @return The distance in bytes between two elements of an accessor
+ */
+size_t get_attribute_stride(const tinygltf::Model *model, uint32_t accessorId);
+
+/**
+ * @return The format of the elements of an accessor
+ */
+VkFormat get_attribute_format(const tinygltf::Model *model, uint32_t accessorId);
+
+/**
+ * @brief Widens each element of an array, the extra bytes are zero
+ * @param src_data The elements
+ * @param src_stride The size of an element
+ * @param dst_stride The size of an element once widened
+ */
+std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uint8_t> &src_data, uint32_t src_stride, uint32_t dst_stride);
+
+/**
+ * @brief Reads the vertices and indices of a primitive from the accessors of the model
+ *        It only reads the model, so the primitives of several meshes can be extracted in parallel
+ */
+PrimitiveData extract_primitive_data(const tinygltf::Model &model, const tinygltf::Primitive &gltf_primitive);
+}        // namespace detail
+}        // namespace vkb
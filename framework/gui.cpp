@@ -916,6 +916,11 @@ void Gui::show_debug_window(DebugInfo &debug_info, const ImVec2 &position)
 		}
 	}
 
+	if (auto *profiler = sample.get_profiler())
+	{
+		show_profiler(*profiler);
+	}
+
 	ImGui::PopFont();
 	ImGui::End();
 }
@@ -967,6 +972,60 @@ void Gui::show_stats(const Stats &stats)
 	}
 }
 
+void Gui::show_profiler(Profiler &profiler)
+{
+	bool enabled = profiler.is_enabled();
+	if (ImGui::Checkbox("Profile Scopes", &enabled))
+	{
+		profiler.set_enabled(enabled);
+	}
+
+	if (!enabled)
+	{
+		return;
+	}
+
+	ImGui::SameLine();
+	if (ImGui::Button("Save Trace"))
+	{
+		profiler.write_chrome_trace(sample.get_name() + "_trace.json");
+	}
+
+	auto  frame = profiler.get_last_frame();
+	auto &style = ImGui::GetStyle();
+	auto &font  = get_font("RobotoMono-Regular");
+
+	ImGui::BeginChild("Profiler", ImVec2(0, debug_view.max_fields * (font.size + style.ItemSpacing.y)), false);
+	ImGui::Columns(3);
+	ImGui::Text("Scope");
+	ImGui::NextColumn();
+	ImGui::Text("CPU ms");
+	ImGui::NextColumn();
+	ImGui::Text("GPU ms");
+	ImGui::NextColumn();
+
+	for (auto &scope : frame.scopes)
+	{
+		// Nested scopes are indented under their parent
+		ImGui::Text("%*s%s", static_cast<int>(scope.depth * 2), "", scope.name.c_str());
+		ImGui::NextColumn();
+		ImGui::Text("%.3f", scope.cpu_end - scope.cpu_begin);
+		ImGui::NextColumn();
+		if (scope.gpu_begin >= 0.0)
+		{
+			ImGui::Text("%.3f", scope.gpu_end - scope.gpu_begin);
+		}
+		else
+		{
+			ImGui::Text("-");
+		}
+		ImGui::NextColumn();
+	}
+
+	ImGui::Columns(1);
+	ImGui::EndChild();
+}
+
 void Gui::show_options_window(std::function<void()> body, const uint32_t lines)
 {
 	// Add padding around the text so that the options are not
@@ -32,6 +32,7 @@
 #include "platform/filesystem.h"
 #include "platform/input_events.h"
 #include "rendering/render_context.h"
+#include "stats/profiler.h"
 #include "stats/stats.h"
 
 namespace vkb
@@ -322,6 +323,12 @@ class Gui
 	 */
 	void show_stats(const Stats &stats);
 
+	/**
+	 * @brief Shows a toggle for the profiler, and the scopes of the last profiled frame with their CPU and GPU times
+	 * @param profiler The profiler of the sample
+	 */
+	void show_profiler(Profiler &profiler);
+
 	/**
 	 * @brief Shows an options windows, to be filled by the sample,
 	 *        which will be positioned at the top
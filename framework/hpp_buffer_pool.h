@@ -29,7 +29,9 @@ namespace vkb
 class HPPBufferAllocation : private vkb::BufferAllocation
 {
   public:
+	using vkb::BufferAllocation::emplace;
 	using vkb::BufferAllocation::update;
+	using vkb::BufferAllocation::update_data;
 
   public:
 	vkb::core::HPPBuffer &get_buffer()
@@ -0,0 +1,55 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <hpp_buffer_pool.h>
+#include <ring_buffer.h>
+#include <vulkan/vulkan.hpp>
+
+namespace vkb
+{
+namespace core
+{
+class HPPDevice;
+}
+
+/**
+ * @brief facade class around vkb::RingBuffer, providing a vulkan.hpp-based interface
+ *
+ * See vkb::RingBuffer for documentation
+ */
+class HPPRingBuffer : private vkb::RingBuffer
+{
+  public:
+	using vkb::RingBuffer::get_high_water_mark;
+	using vkb::RingBuffer::get_size;
+	using vkb::RingBuffer::get_used_size;
+	using vkb::RingBuffer::set_shrink_window;
+
+	HPPRingBuffer(vkb::core::HPPDevice &device, vk::DeviceSize size, vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU) :
+	    vkb::RingBuffer(reinterpret_cast<vkb::Device &>(device), static_cast<VkDeviceSize>(size), static_cast<VkBufferUsageFlags>(usage), memory_usage)
+	{}
+
+	vkb::HPPBufferAllocation allocate(uint32_t size)
+	{
+		vkb::BufferAllocation allocation = vkb::RingBuffer::allocate(size);
+		return std::move(*reinterpret_cast<vkb::HPPBufferAllocation *>(&allocation));
+	}
+};
+}        // namespace vkb
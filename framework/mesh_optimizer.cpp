@@ -0,0 +1,330 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+namespace vkb
+{
+namespace
+{
+const uint32_t INVALID_INDEX = ~0u;
+
+/**
+ * @brief The triangles using each vertex, stored contiguously
+ */
+struct TriangleAdjacency
+{
+	TriangleAdjacency(const std::vector<uint32_t> &indices, uint32_t vertex_count) :
+	    offsets(vertex_count + 1, 0),
+	    triangles(indices.size())
+	{
+		for (auto index : indices)
+		{
+			offsets[index + 1]++;
+		}
+
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	std::vector<uint32_t> offsets;
+
+	std::vector<uint32_t> triangles;
+};
+
+inline glm::vec3 read_position(const uint8_t *positions, size_t stride, uint32_t index)
+{
+	glm::vec3 position;
+	std::memcpy(&position, positions + index * stride, sizeof(position));
+	return position;
+}
+}        // namespace
+
+float compute_acmr(const std::vector<uint32_t> &indices, uint32_t vertex_count, uint32_t cache_size)
+{
+	if (indices.size() < 3)
+	{
+		return 0.0f;
+	}
+
+	// A vertex is in the FIFO while fewer than cache_size vertices entered it after
+	std::vector<uint32_t> cache_time(vertex_count, 0);
+	uint32_t              time   = cache_size + 1;
+	uint32_t              misses = 0;
+
+	for (auto index : indices)
+	{
+		if (time - cache_time[index] > cache_size)
+		{
+			cache_time[index] = time++;
+			misses++;
+		}
+	}
+
+	return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+std::vector<uint32_t> optimize_vertex_cache(std::vector<uint32_t> &indices, uint32_t vertex_count, uint32_t cache_size)
+{
+	assert(indices.size() % 3 == 0 && "Indices must describe a triangle list");
+
+	std::vector<uint32_t> clusters;
+
+	if (indices.empty())
+	{
+		return clusters;
+	}
+
+	TriangleAdjacency adjacency{indices, vertex_count};
+
+	// Number of triangles not emitted yet which use each vertex
+	std::vector<uint32_t> live_triangles(vertex_count);
+	for (uint32_t vertex = 0; vertex < vertex_count; vertex++)
+	{
+		live_triangles[vertex] = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
+	}
+
+	std::vector<uint32_t> cache_time(vertex_count, 0);
+	std::vector<bool>     emitted(indices.size() / 3, false);
+	std::vector<uint32_t> dead_end_stack;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	uint32_t time   = cache_size + 1;
+	uint32_t cursor = 0;
+
+	auto skip_dead_end = [&]() {
+		// Prefer the vertices emitted recently, which may still be in the cache
+		while (!dead_end_stack.empty())
+		{
+			auto vertex = dead_end_stack.back();
+			dead_end_stack.pop_back();
+
+			if (live_triangles[vertex] > 0)
+			{
+				return vertex;
+			}
+		}
+
+		for (; cursor < vertex_count; cursor++)
+		{
+			if (live_triangles[cursor] > 0)
+			{
+				return cursor;
+			}
+		}
+
+		return INVALID_INDEX;
+	};
+
+	uint32_t fanning_vertex = skip_dead_end();
+
+	clusters.push_back(0);
+
+	while (fanning_vertex != INVALID_INDEX)
+	{
+		candidates.clear();
+
+		// Emit the triangles around the fanning vertex
+		for (auto i = adjacency.offsets[fanning_vertex]; i < adjacency.offsets[fanning_vertex + 1]; i++)
+		{
+			auto triangle = adjacency.triangles[i];
+
+			if (emitted[triangle])
+			{
+				continue;
+			}
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				auto vertex = indices[triangle * 3 + corner];
+
+				output.push_back(vertex);
+				dead_end_stack.push_back(vertex);
+				candidates.push_back(vertex);
+
+				live_triangles[vertex]--;
+
+				if (time - cache_time[vertex] > cache_size)
+				{
+					cache_time[vertex] = time++;
+				}
+			}
+
+			emitted[triangle] = true;
+		}
+
+		// Continue with the vertex which stays in the cache while its remaining triangles are emitted
+		uint32_t best_vertex   = INVALID_INDEX;
+		int32_t  best_priority = -1;
+
+		for (auto vertex : candidates)
+		{
+			if (live_triangles[vertex] == 0)
+			{
+				continue;
+			}
+
+			int32_t priority = 0;
+			if (time - cache_time[vertex] + 2 * live_triangles[vertex] <= cache_size)
+			{
+				priority = static_cast<int32_t>(time - cache_time[vertex]);
+			}
+
+			if (priority > best_priority)
+			{
+				best_vertex   = vertex;
+				best_priority = priority;
+			}
+		}
+
+		if (best_vertex == INVALID_INDEX)
+		{
+			// The fan reached a dead end, what follows is not connected to it
+			best_vertex = skip_dead_end();
+
+			if (best_vertex != INVALID_INDEX)
+			{
+				clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+			}
+		}
+
+		fanning_vertex = best_vertex;
+	}
+
+	assert(output.size() == indices.size());
+	indices = std::move(output);
+
+	return clusters;
+}
+
+void optimize_overdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters, const uint8_t *positions, size_t position_stride)
+{
+	auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	struct Cluster
+	{
+		uint32_t begin;
+
+		uint32_t end;
+
+		float sort_key;
+	};
+
+	// Area-weighted centroid and normal of each cluster, and of the whole mesh
+	std::vector<Cluster>   sorted_clusters(clusters.size());
+	std::vector<glm::vec3> centroids(clusters.size());
+	std::vector<glm::vec3> normals(clusters.size());
+	glm::vec3              mesh_centroid{0.0f};
+	float                  mesh_area = 0.0f;
+
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		auto &cluster = sorted_clusters[c];
+		cluster.begin = clusters[c];
+		cluster.end   = c + 1 < clusters.size() ? clusters[c + 1] : triangle_count;
+
+		glm::vec3 centroid{0.0f};
+		glm::vec3 normal{0.0f};
+		float     area = 0.0f;
+
+		for (auto triangle = cluster.begin; triangle < cluster.end; triangle++)
+		{
+			auto p0 = read_position(positions, position_stride, indices[triangle * 3 + 0]);
+			auto p1 = read_position(positions, position_stride, indices[triangle * 3 + 1]);
+			auto p2 = read_position(positions, position_stride, indices[triangle * 3 + 2]);
+
+			auto cross         = glm::cross(p1 - p0, p2 - p0);
+			auto triangle_area = glm::length(cross);
+
+			centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+			normal += cross;
+			area += triangle_area;
+		}
+
+		mesh_centroid += centroid;
+		mesh_area += area;
+
+		centroids[c] = area > 0.0f ? centroid / area : centroid;
+		normals[c]   = glm::length(normal) > 0.0f ? glm::normalize(normal) : normal;
+	}
+
+	if (mesh_area > 0.0f)
+	{
+		mesh_centroid /= mesh_area;
+	}
+
+	// Clusters far out along their normal are on the hull of the mesh, and occlude the ones inside
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		sorted_clusters[c].sort_key = glm::dot(centroids[c] - mesh_centroid, normals[c]);
+	}
+
+	std::stable_sort(sorted_clusters.begin(), sorted_clusters.end(),
+	                 [](const Cluster &lhs, const Cluster &rhs) { return lhs.sort_key > rhs.sort_key; });
+
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	for (auto &cluster : sorted_clusters)
+	{
+		output.insert(output.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+	}
+
+	indices = std::move(output);
+}
+
+std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t> &indices, uint32_t vertex_count)
+{
+	std::vector<uint32_t> remap(vertex_count, INVALID_INDEX);
+	uint32_t              next_vertex = 0;
+
+	for (auto &index : indices)
+	{
+		if (remap[index] == INVALID_INDEX)
+		{
+			remap[index] = next_vertex++;
+		}
+
+		index = remap[index];
+	}
+
+	return remap;
+}
+}        // namespace vkb
@@ -0,0 +1,69 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Size of the post-transform vertex cache the optimizations target, a FIFO of this many vertices
+ *        is a fair model of the caches of current GPUs
+ */
+const uint32_t DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+/**
+ * @brief Computes the average cache miss ratio of a triangle list: the number of vertices transformed per triangle,
+ *        between 0.5 for an ideal mesh and 3 when no vertex is reused
+ * @param indices The indices of the triangle list
+ * @param vertex_count The number of vertices the indices refer to
+ * @param cache_size The size of the simulated FIFO cache
+ */
+float compute_acmr(const std::vector<uint32_t> &indices, uint32_t vertex_count, uint32_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * @brief Reorders the triangles of a triangle list so that they reuse the vertices in the post-transform cache,
+ *        with the Tipsify algorithm (Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw)
+ * @param indices The indices of the triangle list, reordered in place
+ * @param vertex_count The number of vertices the indices refer to
+ * @param cache_size The size of the cache to optimize for
+ * @return The index of the first triangle of each cluster, a run of triangles which is locally connected,
+ *         so that clusters can be reordered without hurting the cache much
+ */
+std::vector<uint32_t> optimize_vertex_cache(std::vector<uint32_t> &indices, uint32_t vertex_count, uint32_t cache_size = DEFAULT_VERTEX_CACHE_SIZE);
+
+/**
+ * @brief Reorders the clusters of a triangle list so that the ones facing outwards are drawn first,
+ *        which makes them likely to occlude the others whatever the view direction
+ * @param indices The indices of the triangle list, reordered in place
+ * @param clusters The first triangle of each cluster, as returned by optimize_vertex_cache
+ * @param positions The positions of the vertices, three floats each
+ * @param position_stride The distance in bytes between two positions
+ */
+void optimize_overdraw(std::vector<uint32_t> &indices, const std::vector<uint32_t> &clusters, const uint8_t *positions, size_t position_stride);
+
+/**
+ * @brief Renumbers the vertices in the order the indices first use them, so that vertex fetches read memory linearly
+ * @param indices The indices of the triangle list, rewritten in place
+ * @param vertex_count The number of vertices the indices refer to
+ * @return The new index of each vertex, or ~0u for the vertices which are not used
+ */
+std::vector<uint32_t> optimize_vertex_fetch(std::vector<uint32_t> &indices, uint32_t vertex_count);
+}        // namespace vkb
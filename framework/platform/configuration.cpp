@@ -97,6 +97,11 @@ void Configuration::reset()
 	current_configuration = configs.begin();
 }
 
+uint32_t Configuration::get_current_index() const
+{
+	return current_configuration != configs.end() ? current_configuration->first : 0;
+}
+
 void Configuration::insert_setting(uint32_t config_index, std::unique_ptr<Setting> setting)
 {
 	settings.push_back(std::move(setting));
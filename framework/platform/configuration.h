@@ -111,6 +111,12 @@ class Configuration
 	 */
 	void reset();
 
+	/**
+	 * @brief Gets the index of the current configuration
+	 * @returns The index the settings of the current configuration were inserted with, or 0 if there are none
+	 */
+	uint32_t get_current_index() const;
+
 	/**
 	 * @brief Inserts a setting into the current configuration
 	 * @param config_index The configuration to insert the setting into
@@ -17,6 +17,12 @@
 
 #include "platform/filesystem.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
 #include "common/error.h"
 
 VKBP_DISABLE_WARNINGS()
@@ -157,6 +163,96 @@ std::vector<uint8_t> read_binary_file(const std::string &filename, const uint32_
 	return data;
 }
 
+FileData::FileData(const uint8_t *data, size_t size, std::shared_ptr<const void> owner) :
+    bytes{data},
+    byte_count{size},
+    owner{std::move(owner)}
+{
+}
+
+const uint8_t *FileData::data() const
+{
+	return bytes;
+}
+
+size_t FileData::size() const
+{
+	return byte_count;
+}
+
+bool FileData::empty() const
+{
+	return byte_count == 0;
+}
+
+const uint8_t *FileData::begin() const
+{
+	return bytes;
+}
+
+const uint8_t *FileData::end() const
+{
+	return bytes + byte_count;
+}
+
+FileData map_file(const std::string &filename)
+{
+#if defined(__unix__) || defined(__APPLE__)
+	int fd = open(filename.c_str(), O_RDONLY);
+
+	if (fd < 0)
+	{
+		throw std::runtime_error("Failed to open file: " + filename);
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("Failed to stat file: " + filename);
+	}
+
+	auto size = static_cast<size_t>(info.st_size);
+
+	if (size == 0)
+	{
+		close(fd);
+		return {};
+	}
+
+	void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping keeps a reference to the file
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+	{
+		throw std::runtime_error("Failed to map file: " + filename);
+	}
+
+	// Assets are parsed front to back, let the kernel read ahead
+	madvise(mapping, size, MADV_SEQUENTIAL);
+
+	std::shared_ptr<const void> owner{mapping, [size](const void *mapping) { munmap(const_cast<void *>(mapping), size); }};
+
+	return {static_cast<const uint8_t *>(mapping), size, std::move(owner)};
+#else
+	auto data = std::make_shared<std::vector<uint8_t>>(read_binary_file(filename, 0));
+
+	return {data->data(), data->size(), data};
+#endif
+}
+
+FileData map_asset(const std::string &filename)
+{
+	return map_file(path::get(path::Type::Assets) + filename);
+}
+
+FileData map_temp(const std::string &filename)
+{
+	return map_file(path::get(path::Type::Temp) + filename);
+}
+
 static void write_binary_file(const std::vector<uint8_t> &data, const std::string &filename, const uint32_t count)
 {
 	std::ofstream file;
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <sys/stat.h>
 #include <unordered_map>
@@ -90,6 +91,67 @@ void create_directory(const std::string &path);
  */
 void create_path(const std::string &root, const std::string &path);
 
+/**
+ * @brief Read-only content of a file, which stays valid as long as a copy of the object lives
+ *
+ * On unix platforms the file is mapped in memory, so its pages are read on demand and shared
+ * with the page cache instead of being copied. Elsewhere the file is read into memory.
+ */
+class FileData
+{
+  public:
+	FileData() = default;
+
+	/**
+	 * @brief Wraps bytes owned by another object
+	 * @param data The first byte
+	 * @param size The number of bytes
+	 * @param owner Keeps the bytes alive
+	 */
+	FileData(const uint8_t *data, size_t size, std::shared_ptr<const void> owner);
+
+	const uint8_t *data() const;
+
+	size_t size() const;
+
+	bool empty() const;
+
+	const uint8_t *begin() const;
+
+	const uint8_t *end() const;
+
+  private:
+	const uint8_t *bytes{nullptr};
+
+	size_t byte_count{0};
+
+	std::shared_ptr<const void> owner;
+};
+
+/**
+ * @brief Maps a file in memory, or reads it on platforms which cannot map it
+ *
+ * @param filename The absolute path to the file
+ * @return The content of the file
+ */
+FileData map_file(const std::string &filename);
+
+/**
+ * @brief Helper to map an asset file in memory
+ *
+ * @param filename The path to the file (relative to the assets directory)
+ * @return The content of the file
+ */
+FileData map_asset(const std::string &filename);
+
+/**
+ * @brief Helper to map a temporary file in memory
+ *
+ * @param filename The path to the file (relative to the temporary storage directory)
+ * @return The content of the file
+ */
+FileData map_temp(const std::string &filename);
+
 /**
  * @brief Helper to read an asset file into a byte-array
  *
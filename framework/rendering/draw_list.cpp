@@ -0,0 +1,132 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/draw_list.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Returns the bits of a non-negative float, which sort in the same order as the float itself
+ */
+inline uint32_t depth_bits(float distance)
+{
+	distance = distance > 0.0f ? distance : 0.0f;
+
+	uint32_t bits;
+	std::memcpy(&bits, &distance, sizeof(bits));
+	return bits;
+}
+
+/**
+ * @brief Returns the power of two range of a distance on 4 bits: below 1, then [1, 2), [2, 4)... up to 2^14 and beyond
+ */
+inline uint32_t depth_range(float distance)
+{
+	// The exponent of a non-negative float is its power of two range
+	int32_t exponent = static_cast<int32_t>(depth_bits(distance) >> 23) - 127;
+
+	return static_cast<uint32_t>(std::min(std::max(exponent + 1, 0), 15));
+}
+}        // namespace
+
+uint64_t DrawList::opaque_key(uint32_t pipeline_id, float distance, uint32_t material_id)
+{
+	// Pipeline state (16 bits), depth range (4 bits), material (16 bits), then the depth without its lowest bits (28 bits)
+	return (static_cast<uint64_t>(pipeline_id & 0xFFFF) << 48) |
+	       (static_cast<uint64_t>(depth_range(distance)) << 44) |
+	       (static_cast<uint64_t>(material_id & 0xFFFF) << 28) |
+	       static_cast<uint64_t>(depth_bits(distance) >> 4);
+}
+
+uint64_t DrawList::transparent_key(float distance)
+{
+	// Invert the depth so that the furthest objects come first
+	return static_cast<uint64_t>(~depth_bits(distance));
+}
+
+void DrawList::clear()
+{
+	items.clear();
+}
+
+void DrawList::add(uint64_t key, sg::Node &node, sg::SubMesh &sub_mesh)
+{
+	items.push_back({key, &node, &sub_mesh});
+}
+
+void DrawList::sort()
+{
+	if (items.size() < 2)
+	{
+		return;
+	}
+
+	sorted_items.resize(items.size());
+
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		std::array<size_t, 256> offsets{};
+
+		for (auto &item : items)
+		{
+			offsets[(item.key >> shift) & 0xFF]++;
+		}
+
+		// Every key has the same byte here, this pass would not change the order
+		if (offsets[(items[0].key >> shift) & 0xFF] == items.size())
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (auto &bucket : offsets)
+		{
+			size_t count = bucket;
+			bucket       = offset;
+			offset += count;
+		}
+
+		for (auto &item : items)
+		{
+			sorted_items[offsets[(item.key >> shift) & 0xFF]++] = item;
+		}
+
+		std::swap(items, sorted_items);
+	}
+}
+
+bool DrawList::empty() const
+{
+	return items.empty();
+}
+
+size_t DrawList::size() const
+{
+	return items.size();
+}
+
+const std::vector<DrawItem> &DrawList::get_items() const
+{
+	return items;
+}
+}        // namespace vkb
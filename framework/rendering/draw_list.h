@@ -0,0 +1,94 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class SubMesh;
+}        // namespace sg
+
+/**
+ * @brief A single draw of a submesh instanced by a node
+ */
+struct DrawItem
+{
+	uint64_t key;
+
+	sg::Node *node;
+
+	sg::SubMesh *sub_mesh;
+};
+
+/**
+ * @brief A flat list of draws ordered by a 64-bit sort key
+ *
+ * The list is meant to be kept alive and refilled every frame, so that its
+ * storage is reused instead of allocating a node per draw. Sorting is done
+ * with a stable LSD radix sort, skipping the key bytes which are identical
+ * for every item.
+ */
+class DrawList
+{
+  public:
+	/**
+	 * @brief Builds a key drawing opaque objects grouped by pipeline state, then by depth range and material
+	 *        Depth ranges are powers of two, so the draws are roughly front-to-back while the draws of a
+	 *        material within a range are consecutive. They are front-to-back within a material.
+	 * @param pipeline_id Identifier of the pipeline state, only the lower 16 bits are used
+	 * @param distance Distance from the camera, must not be negative
+	 * @param material_id Identifier of the material, only the lower 16 bits are used
+	 */
+	static uint64_t opaque_key(uint32_t pipeline_id, float distance, uint32_t material_id);
+
+	/**
+	 * @brief Builds a key drawing transparent objects back-to-front
+	 * @param distance Distance from the camera, must not be negative
+	 */
+	static uint64_t transparent_key(float distance);
+
+	/**
+	 * @brief Removes all draws, keeping the allocated storage
+	 */
+	void clear();
+
+	void add(uint64_t key, sg::Node &node, sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Sorts the draws by ascending key
+	 */
+	void sort();
+
+	bool empty() const;
+
+	size_t size() const;
+
+	const std::vector<DrawItem> &get_items() const;
+
+  private:
+	std::vector<DrawItem> items;
+
+	/// Scratch storage for the radix sort passes
+	std::vector<DrawItem> sorted_items;
+};
+}        // namespace vkb
@@ -22,6 +22,7 @@
 #include <core/hpp_command_buffer.h>
 #include <core/hpp_queue.h>
 #include <hpp_buffer_pool.h>
+#include <hpp_ring_buffer.h>
 #include <rendering/hpp_render_target.h>
 
 namespace vkb
@@ -37,6 +38,7 @@ class HPPRenderFrame : private vkb::RenderFrame
 {
   public:
 	using vkb::RenderFrame::reset;
+	using vkb::RenderFrame::set_shared_buffer_pools;
 
 	HPPRenderFrame(vkb::core::HPPDevice &device, std::unique_ptr<HPPRenderTarget> &&render_target, size_t thread_count = 1) :
 	    RenderFrame(reinterpret_cast<vkb::Device &>(device),
@@ -87,6 +89,11 @@ class HPPRenderFrame : private vkb::RenderFrame
 		return static_cast<vk::Semaphore>(vkb::RenderFrame::request_semaphore_with_ownership());
 	}
 
+	void set_ring_buffer(vk::BufferUsageFlags usage, vkb::HPPRingBuffer *ring_buffer)
+	{
+		vkb::RenderFrame::set_ring_buffer(static_cast<VkBufferUsageFlags>(usage), reinterpret_cast<vkb::RingBuffer *>(ring_buffer));
+	}
+
 	void update_render_target(std::unique_ptr<HPPRenderTarget> &&render_target)
 	{
 		vkb::RenderFrame::update_render_target(std::unique_ptr<vkb::RenderTarget>(reinterpret_cast<vkb::RenderTarget *>(render_target.release())));
@@ -197,6 +197,8 @@ class PipelineState
 
 	void set_subpass_index(uint32_t subpass_index);
 
+	bool has_pipeline_layout() const;
+
 	const PipelineLayout &get_pipeline_layout() const;
 
 	const RenderPass *get_render_pass() const;
@@ -233,6 +233,7 @@ void RenderContext::recreate()
 		{
 			// Create a new frame if the new swapchain has more images than current frames
 			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			frames.back()->set_profiler(frames.front()->get_profiler());
 		}
 
 		++frame_it;
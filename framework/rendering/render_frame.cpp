@@ -49,6 +49,7 @@ RenderFrame::RenderFrame(Device &device, std::unique_ptr<RenderTarget> &&render_
 	{
 		descriptor_pools.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorPool>>());
 		descriptor_sets.push_back(std::make_unique<std::unordered_map<std::size_t, DescriptorSet>>());
+		descriptor_set_keys.emplace_back();
 	}
 }
 
@@ -68,6 +69,16 @@ void RenderFrame::reset()
 
 	fence_pool.reset();
 
+	for (auto &ring_buffer : ring_buffers)
+	{
+		ring_buffer.second->begin_frame(*this);
+	}
+
+	if (profiler)
+	{
+		profiler->begin_frame(*this);
+	}
+
 	for (auto &command_pools_per_queue : command_pools)
 	{
 		for (auto &command_pool : command_pools_per_queue.second)
@@ -245,6 +256,36 @@ void RenderFrame::update_descriptor_sets(size_t thread_index)
 	}
 }
 
+VkDescriptorSet RenderFrame::find_descriptor_set(std::size_t key, size_t thread_index) const
+{
+	if (descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	assert(thread_index < descriptor_set_keys.size());
+	auto &thread_descriptor_set_keys = descriptor_set_keys[thread_index];
+
+	auto it = thread_descriptor_set_keys.find(key);
+	if (it == thread_descriptor_set_keys.end())
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return it->second;
+}
+
+void RenderFrame::cache_descriptor_set(std::size_t key, VkDescriptorSet descriptor_set, size_t thread_index)
+{
+	if (descriptor_management_strategy != DescriptorManagementStrategy::StoreInCache)
+	{
+		return;
+	}
+
+	assert(thread_index < descriptor_set_keys.size());
+	descriptor_set_keys[thread_index][key] = descriptor_set;
+}
+
 void RenderFrame::clear_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
@@ -252,6 +293,11 @@ void RenderFrame::clear_descriptors()
 		desc_sets_per_thread->clear();
 	}
 
+	for (auto &desc_set_keys_per_thread : descriptor_set_keys)
+	{
+		desc_set_keys_per_thread.clear();
+	}
+
 	for (auto &desc_pools_per_thread : descriptor_pools)
 	{
 		for (auto &desc_pool : *desc_pools_per_thread)
@@ -268,12 +314,61 @@ void RenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_st
 
 void RenderFrame::set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy)
 {
+	if (new_strategy != descriptor_management_strategy)
+	{
+		// Descriptor pools are reset every frame when creating descriptor sets directly
+		for (auto &desc_set_keys_per_thread : descriptor_set_keys)
+		{
+			desc_set_keys_per_thread.clear();
+		}
+	}
+
 	descriptor_management_strategy = new_strategy;
 }
 
+void RenderFrame::set_shared_buffer_pools(bool shared)
+{
+	shared_buffer_pools = shared;
+}
+
+void RenderFrame::set_ring_buffer(VkBufferUsageFlags usage, RingBuffer *ring_buffer)
+{
+	if (ring_buffer)
+	{
+		ring_buffers[usage] = ring_buffer;
+	}
+	else
+	{
+		ring_buffers.erase(usage);
+	}
+}
+
+RingBuffer *RenderFrame::get_ring_buffer(VkBufferUsageFlags usage) const
+{
+	auto it = ring_buffers.find(usage);
+	return it != ring_buffers.end() ? it->second : nullptr;
+}
+
+void RenderFrame::set_profiler(Profiler *profiler)
+{
+	this->profiler = profiler;
+}
+
+Profiler *RenderFrame::get_profiler() const
+{
+	return profiler;
+}
+
 BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, const VkDeviceSize size, size_t thread_index)
 {
-	assert(thread_index < thread_count && "Thread index is out of bounds");
+	assert((shared_buffer_pools || thread_index < thread_count) && "Thread index is out of bounds");
+
+	// Ring buffers grow on demand, so they are not limited by the block size
+	auto ring_buffer_it = ring_buffers.find(usage);
+	if (ring_buffer_it != ring_buffers.end())
+	{
+		return ring_buffer_it->second->allocate(to_u32(size));
+	}
 
 	uint32_t block_multiplier = supported_usage_map.at(usage);
 
@@ -291,12 +386,18 @@ BufferAllocation RenderFrame::allocate_buffer(const VkBufferUsageFlags usage, co
 		return BufferAllocation{};
 	}
 
+	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer;
+
+	if (shared_buffer_pools)
+	{
+		// The first pool is shared by all threads
+		return buffer_pool_it->second[0].first.allocate(to_u32(size), want_minimal_block);
+	}
+
 	assert(thread_index < buffer_pool_it->second.size());
 	auto &buffer_pool  = buffer_pool_it->second[thread_index].first;
 	auto &buffer_block = buffer_pool_it->second[thread_index].second;
 
-	bool want_minimal_block = buffer_allocation_strategy == BufferAllocationStrategy::OneAllocationPerBuffer;
-
 	if (want_minimal_block || !buffer_block)
 	{
 		// If there is no block associated with the pool or we are creating a buffer for each allocation,
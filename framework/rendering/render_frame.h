@@ -30,7 +30,9 @@
 #include "core/queue.h"
 #include "fence_pool.h"
 #include "rendering/render_target.h"
+#include "ring_buffer.h"
 #include "semaphore_pool.h"
+#include "stats/profiler.h"
 
 namespace vkb
 {
@@ -129,6 +131,20 @@ class RenderFrame
 	                                       bool                                      update_after_bind,
 	                                       size_t                                    thread_index = 0);
 
+	/**
+	 * @brief Looks up a descriptor set previously cached with a key, without building its buffer and image infos
+	 * @param key A key identifying the layout and the resources of the descriptor set
+	 * @param thread_index Selects the thread's descriptor sets
+	 * @return The descriptor set, or VK_NULL_HANDLE if none was cached with this key
+	 */
+	VkDescriptorSet find_descriptor_set(std::size_t key, size_t thread_index = 0) const;
+
+	/**
+	 * @brief Associates a key to a descriptor set returned by request_descriptor_set, so that find_descriptor_set can return it
+	 *        It has no effect unless descriptor sets are stored in cache
+	 */
+	void cache_descriptor_set(std::size_t key, VkDescriptorSet descriptor_set, size_t thread_index = 0);
+
 	void clear_descriptors();
 
 	/**
@@ -143,10 +159,38 @@ class RenderFrame
 	 */
 	void set_descriptor_management_strategy(DescriptorManagementStrategy new_strategy);
 
+	/**
+	 * @brief Sets whether all threads allocate buffers from a single pool per usage
+	 *        Shared pools are safe to allocate from concurrently, and avoid leaving a partially filled block per thread
+	 * @param shared Whether buffer pools are shared across threads
+	 */
+	void set_shared_buffer_pools(bool shared);
+
+	/**
+	 * @brief Streams the allocations of a usage through a ring buffer shared with the other frames,
+	 *        instead of the buffer pools of the frame
+	 * @param usage Usage of the buffers allocated from the ring
+	 * @param ring_buffer The ring buffer, which must outlive the frame, or nullptr to go back to the buffer pools
+	 */
+	void set_ring_buffer(VkBufferUsageFlags usage, RingBuffer *ring_buffer);
+
+	/**
+	 * @return The ring buffer the allocations of a usage are streamed through, or nullptr if they come from the buffer pools
+	 */
+	RingBuffer *get_ring_buffer(VkBufferUsageFlags usage) const;
+
+	/**
+	 * @brief Profiles the scopes recorded in the command buffers of the frame
+	 * @param profiler The profiler, which must outlive the frame, or nullptr to stop profiling
+	 */
+	void set_profiler(Profiler *profiler);
+
+	Profiler *get_profiler() const;
+
 	/**
 	 * @param usage Usage of the buffer
 	 * @param size Amount of memory required
-	 * @param thread_index Index of the buffer pool to be used by the current thread
+	 * @param thread_index Index of the buffer pool to be used by the current thread, ignored if buffer pools are shared
 	 * @return The requested allocation, it may be empty
 	 */
 	BufferAllocation allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
@@ -177,6 +221,9 @@ class RenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> descriptor_sets;
 
+	/// Descriptor sets for the frame by the keys command buffers track them with
+	std::vector<std::unordered_map<std::size_t, VkDescriptorSet>> descriptor_set_keys;
+
 	FencePool fence_pool;
 
 	SemaphorePool semaphore_pool;
@@ -188,6 +235,12 @@ class RenderFrame
 	BufferAllocationStrategy     buffer_allocation_strategy{BufferAllocationStrategy::MultipleAllocationsPerBuffer};
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
+	bool shared_buffer_pools{false};
+
+	std::map<VkBufferUsageFlags, RingBuffer *> ring_buffers;
+
+	Profiler *profiler{nullptr};
+
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPool, BufferBlock *>>> buffer_pools;
 
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
@@ -40,6 +40,8 @@ ForwardSubpass::ForwardSubpass(RenderContext &render_context, ShaderSource &&ver
 void ForwardSubpass::prepare()
 {
 	auto &device = render_context.get_device();
+
+	std::vector<ShaderModuleRequest> shader_module_requests;
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
@@ -51,10 +53,12 @@ void ForwardSubpass::prepare()
 
 			variant.add_definitions(light_type_definitions);
 
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			shader_module_requests.push_back({VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant});
+			shader_module_requests.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant});
 		}
 	}
+
+	device.get_resource_cache().request_shader_modules(shader_module_requests);
 }
 
 void ForwardSubpass::draw(CommandBuffer &command_buffer)
@@ -16,6 +16,9 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <cstring>
+
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
@@ -27,6 +30,7 @@
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
+#include "stats/stats.h"
 
 namespace vkb
 {
@@ -40,23 +44,44 @@ GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&v
 
 void GeometrySubpass::prepare()
 {
-	// Build all shader variance upfront
+	// Build all shader variance upfront, compiling them in parallel
 	auto &device = render_context.get_device();
+
+	std::vector<ShaderModuleRequest> shader_module_requests;
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			auto &variant = sub_mesh->get_shader_variant();
+			shader_module_requests.push_back({VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant});
+			shader_module_requests.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant});
 		}
 	}
+
+	device.get_resource_cache().request_shader_modules(shader_module_requests);
 }
 
-void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+void GeometrySubpass::get_sorted_nodes(DrawList &opaque_nodes, DrawList &transparent_nodes)
 {
+	opaque_nodes.clear();
+	transparent_nodes.clear();
+
+	// Sort keys only need to be consistent within a frame. Variants are rebuilt when the subpass is prepared
+	// again and materials go away with their scene, so identifiers kept across frames would never be released
+	pipeline_ids.clear();
+	material_ids.clear();
+
 	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
 
+	Frustum frustum;
+	if (frustum_culling)
+	{
+		frustum.update(camera.get_projection() * camera.get_view());
+	}
+
+	uint32_t visible_count = 0;
+	uint32_t culled_count  = 0;
+
 	for (auto &mesh : meshes)
 	{
 		for (auto &node : mesh->get_nodes())
@@ -68,44 +93,84 @@ void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *
 			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
 			world_bounds.transform(node_transform);
 
+			if (frustum_culling && !frustum.check_aabb(world_bounds.get_min(), world_bounds.get_max()))
+			{
+				culled_count += to_u32(mesh->get_submeshes().size());
+				continue;
+			}
+
+			visible_count += to_u32(mesh->get_submeshes().size());
+
 			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
 
+			// Flipped meshes are drawn with an inverted front face, which is a different pipeline state
+			const auto &scale   = node->get_transform().get_scale();
+			bool        flipped = scale.x * scale.y * scale.z < 0;
+
 			for (auto &sub_mesh : mesh->get_submeshes())
 			{
-				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+				auto material = sub_mesh->get_material();
+
+				if (material->alpha_mode == sg::AlphaMode::Blend)
 				{
-					transparent_nodes.emplace(distance, std::make_pair(node, sub_mesh));
+					transparent_nodes.add(DrawList::transparent_key(distance), *node, *sub_mesh);
 				}
 				else
 				{
-					opaque_nodes.emplace(distance, std::make_pair(node, sub_mesh));
+					size_t pipeline_hash = sub_mesh->get_shader_variant().get_id();
+					hash_combine(pipeline_hash, material->double_sided);
+					hash_combine(pipeline_hash, flipped);
+
+					auto pipeline_id = pipeline_ids.emplace(pipeline_hash, to_u32(pipeline_ids.size())).first->second;
+					auto material_id = material_ids.emplace(material, to_u32(material_ids.size())).first->second;
+
+					opaque_nodes.add(DrawList::opaque_key(pipeline_id, distance, material_id), *node, *sub_mesh);
 				}
 			}
 		}
 	}
+
+	opaque_nodes.sort();
+	transparent_nodes.sort();
+
+	if (stats)
+	{
+		stats->record_culling(visible_count, culled_count);
+	}
 }
 
 void GeometrySubpass::draw(CommandBuffer &command_buffer)
 {
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+	get_sorted_nodes(opaque_draws, transparent_draws);
+
+	if (uniform_batching)
+	{
+		update_uniform_batches();
+	}
 
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
+	size_t draw_index = 0;
 
-	// Draw opaque objects in front-to-back order
+	// Draw opaque objects grouped by pipeline state, in front-to-back order
 	{
 		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+		for (auto &draw_item : opaque_draws.get_items())
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			if (uniform_batching)
+			{
+				bind_batched_uniform(command_buffer, draw_index++);
+			}
+			else
+			{
+				update_uniform(command_buffer, *draw_item.node, thread_index);
+			}
 
 			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
+			const auto &scale      = draw_item.node->get_transform().get_scale();
 			bool        flipped    = scale.x * scale.y * scale.z < 0;
 			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
+			draw_submesh(command_buffer, *draw_item.sub_mesh, front_face);
 		}
 	}
 
@@ -130,11 +195,18 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 	{
 		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+		for (auto &draw_item : transparent_draws.get_items())
 		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+			if (uniform_batching)
+			{
+				bind_batched_uniform(command_buffer, draw_index++);
+			}
+			else
+			{
+				update_uniform(command_buffer, *draw_item.node, thread_index);
+			}
 
-			draw_submesh(command_buffer, *node_it->second.second);
+			draw_submesh(command_buffer, *draw_item.sub_mesh);
 		}
 	}
 }
@@ -160,6 +232,69 @@ void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &no
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
 }
 
+void GeometrySubpass::update_uniform_batches()
+{
+	auto &render_frame = get_render_context().get_active_frame();
+
+	// Each uniform has to start at a valid dynamic offset
+	VkDeviceSize alignment = get_render_context().get_device().get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+	alignment              = std::max<VkDeviceSize>(alignment, 1);
+	uniform_batch_stride   = (sizeof(GlobalUniform) + alignment - 1) / alignment * alignment;
+
+	const auto &opaque_items      = opaque_draws.get_items();
+	const auto &transparent_items = transparent_draws.get_items();
+	size_t      draw_count        = opaque_items.size() + transparent_items.size();
+
+	if (render_frame.get_ring_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT))
+	{
+		// A ring buffer grows to fit the allocation, all the uniforms of the frame go in a single one
+		uniform_batch_capacity = std::max<size_t>(draw_count, 1);
+	}
+	else
+	{
+		// A single allocation cannot be larger than a block of the uniform buffer pool
+		uniform_batch_capacity = static_cast<size_t>(RenderFrame::BUFFER_POOL_BLOCK_SIZE * 1024 / uniform_batch_stride);
+	}
+
+	uniform_batches.clear();
+
+	GlobalUniform global_uniform;
+	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+	global_uniform.camera_position  = glm::vec3(glm::inverse(camera.get_view())[3]);
+
+	for (size_t first = 0; first < draw_count; first += uniform_batch_capacity)
+	{
+		size_t count = std::min(uniform_batch_capacity, draw_count - first);
+
+		uniform_batch_data.resize(static_cast<size_t>(count * uniform_batch_stride));
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			size_t          draw_index = first + i;
+			const DrawItem &draw_item  = draw_index < opaque_items.size() ? opaque_items[draw_index] : transparent_items[draw_index - opaque_items.size()];
+
+			global_uniform.model = draw_item.node->get_transform().get_world_matrix();
+
+			std::memcpy(uniform_batch_data.data() + i * uniform_batch_stride, &global_uniform, sizeof(GlobalUniform));
+		}
+
+		auto allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, uniform_batch_data.size(), thread_index);
+
+		allocation.update(uniform_batch_data);
+
+		uniform_batches.push_back(std::move(allocation));
+	}
+}
+
+void GeometrySubpass::bind_batched_uniform(CommandBuffer &command_buffer, size_t draw_index)
+{
+	auto &allocation = uniform_batches[draw_index / uniform_batch_capacity];
+
+	VkDeviceSize offset = allocation.get_offset() + (draw_index % uniform_batch_capacity) * uniform_batch_stride;
+
+	command_buffer.bind_buffer(allocation.get_buffer(), offset, sizeof(GlobalUniform), 0, 1, 0);
+}
+
 void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face)
 {
 	auto &device = command_buffer.get_device();
@@ -192,7 +327,7 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	{
 		if (auto layout_binding = descriptor_set_layout.get_layout_binding(texture.first))
 		{
-			command_buffer.bind_image(texture.second->get_image()->get_vk_image_view(),
+			command_buffer.bind_image(texture.second->get_image_view(),
 			                          texture.second->get_sampler()->vk_sampler,
 			                          0, layout_binding->binding, 0);
 		}
@@ -231,15 +366,16 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	// Find submesh vertex buffers matching the shader input attribute names
 	for (auto &input_resource : vertex_input_resources)
 	{
-		const auto &buffer_iter = sub_mesh.vertex_buffers.find(input_resource.name);
+		const core::Buffer *buffer = nullptr;
+		VkDeviceSize        offset = 0;
 
-		if (buffer_iter != sub_mesh.vertex_buffers.end())
+		if (sub_mesh.get_vertex_buffer(input_resource.name, buffer, offset))
 		{
 			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
+			buffers.emplace_back(std::ref(*buffer));
 
 			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {offset});
 		}
 	}
 
@@ -286,12 +422,7 @@ void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::
 	pbr_material_uniform.metallic_factor   = pbr_material->metallic_factor;
 	pbr_material_uniform.roughness_factor  = pbr_material->roughness_factor;
 
-	auto data = to_bytes(pbr_material_uniform);
-
-	if (!data.empty())
-	{
-		command_buffer.push_constants(data);
-	}
+	command_buffer.push_constants(pbr_material_uniform);
 }
 
 void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
@@ -300,10 +431,10 @@ void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::Su
 	if (sub_mesh.vertex_indices != 0)
 	{
 		// Bind index buffer of submesh
-		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+		command_buffer.bind_index_buffer(*sub_mesh.get_index_buffer(), sub_mesh.index_offset, sub_mesh.index_type);
 
 		// Draw submesh using indexed data
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
+		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, sub_mesh.first_index, 0, 0);
 	}
 	else
 	{
@@ -316,4 +447,47 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_frustum_culling(bool enable)
+{
+	frustum_culling = enable;
+}
+
+void GeometrySubpass::set_stats(Stats *stats_)
+{
+	stats = stats_;
+}
+
+void GeometrySubpass::set_uniform_batching(bool enable)
+{
+	if (uniform_batching == enable)
+	{
+		return;
+	}
+
+	uniform_batching = enable;
+
+	auto it = resource_mode_map.find("GlobalUniform");
+
+	if (uniform_batching)
+	{
+		// The mode set by the user of the subpass is restored once batching is disabled
+		has_global_uniform_mode = it != resource_mode_map.end();
+		if (has_global_uniform_mode)
+		{
+			global_uniform_mode = it->second;
+		}
+
+		// The offset of each draw within a batch is passed as a dynamic offset
+		resource_mode_map["GlobalUniform"] = ShaderResourceMode::Dynamic;
+	}
+	else if (has_global_uniform_mode)
+	{
+		resource_mode_map["GlobalUniform"] = global_uniform_mode;
+	}
+	else if (it != resource_mode_map.end())
+	{
+		resource_mode_map.erase(it);
+	}
+}
 }        // namespace vkb
@@ -23,16 +23,21 @@ VKBP_DISABLE_WARNINGS()
 #include "common/glm_common.h"
 VKBP_ENABLE_WARNINGS()
 
+#include "geometry/frustum.h"
+#include "rendering/draw_list.h"
 #include "rendering/subpass.h"
 
 namespace vkb
 {
+class Stats;
+
 namespace sg
 {
 class Scene;
 class Node;
 class Mesh;
 class SubMesh;
+class Material;
 class Camera;
 }        // namespace sg
 
@@ -90,9 +95,41 @@ class GeometrySubpass : public Subpass
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Enables skipping the meshes whose bounding box lies outside of the camera frustum
+	 * @param enable Whether frustum culling is enabled
+	 */
+	void set_frustum_culling(bool enable);
+
+	/**
+	 * @brief Sets the stats which the number of visible and culled submeshes are reported to
+	 * @param stats The stats, or nullptr to stop reporting
+	 */
+	void set_stats(Stats *stats);
+
+	/**
+	 * @brief Enables writing the uniforms of all the nodes drawn in a frame into a few large allocations,
+	 *        instead of allocating one buffer per node. Each draw then selects its uniform with a dynamic offset,
+	 *        so the same descriptor set is shared by all the draws of a batch
+	 *        When enabled, update_uniform() is not called anymore. Disabling it restores the previous resource mode of the uniform
+	 * @param enable Whether uniform batching is enabled
+	 */
+	void set_uniform_batching(bool enable);
+
   protected:
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
+	/**
+	 * @brief Writes the uniforms of all the sorted draws into per-frame allocations
+	 */
+	void update_uniform_batches();
+
+	/**
+	 * @brief Binds the uniform of a draw written by update_uniform_batches()
+	 * @param draw_index Index of the draw, opaque draws first then transparent draws
+	 */
+	void bind_batched_uniform(CommandBuffer &command_buffer, size_t draw_index);
+
 	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
 
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
@@ -104,11 +141,12 @@ class GeometrySubpass : public Subpass
 	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
 
 	/**
-	 * @brief Sorts objects based on distance from camera and classifies them
-	 *        into opaque and transparent in the arrays provided
+	 * @brief Sorts objects and classifies them into opaque and transparent in the lists provided
+	 *        Opaque objects are grouped by pipeline state then sorted front-to-back,
+	 *        transparent objects are sorted back-to-front
+	 *        If frustum culling is enabled, objects outside of the camera frustum are skipped
 	 */
-	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
-	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
+	void get_sorted_nodes(DrawList &opaque_nodes, DrawList &transparent_nodes);
 
 	sg::Camera &camera;
 
@@ -118,6 +156,39 @@ class GeometrySubpass : public Subpass
 
 	uint32_t thread_index{0};
 
+	bool frustum_culling{false};
+
+	/// Draw lists refilled every frame, so that their storage is reused
+	DrawList opaque_draws;
+
+	DrawList transparent_draws;
+
+	/// Small identifiers for the pipeline states and materials drawn in the current frame, used to build sort keys
+	std::unordered_map<size_t, uint32_t> pipeline_ids;
+
+	std::unordered_map<const sg::Material *, uint32_t> material_ids;
+
+	Stats *stats{nullptr};
+
+	bool uniform_batching{false};
+
+	/// Resource mode of the global uniform before batching made it dynamic, if it had one
+	bool has_global_uniform_mode{false};
+
+	ShaderResourceMode global_uniform_mode{};
+
+	/// Allocations holding the uniforms of the current frame, each one fits in a buffer pool block
+	std::vector<BufferAllocation> uniform_batches;
+
+	/// Staging memory reused across frames to fill a batch before it is uploaded
+	std::vector<uint8_t> uniform_batch_data;
+
+	/// Aligned size of a uniform within a batch
+	VkDeviceSize uniform_batch_stride{0};
+
+	/// Number of uniforms which fit in a batch
+	size_t uniform_batch_capacity{0};
+
 	vkb::RasterizationState base_rasterization_state{};
 };
 
@@ -17,13 +17,19 @@
 
 #include "resource_binding_state.h"
 
+#include "common/helpers.h"
+
 namespace vkb
 {
 void ResourceBindingState::reset()
 {
 	clear_dirty();
 
-	resource_sets.clear();
+	// Keep the sets, so that their binding tables are reused
+	for (auto &resource_set : resource_sets)
+	{
+		resource_set.second.reset();
+	}
 }
 
 bool ResourceBindingState::is_dirty()
@@ -93,48 +99,93 @@ void ResourceSet::clear_dirty()
 
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty = false;
+	get_resource_binding(binding, array_element).info.dirty = false;
 }
 
 void ResourceSet::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	auto &resource_binding = get_resource_binding(binding, array_element);
 
-	dirty = true;
+	resource_binding.info.buffer = &buffer;
+	resource_binding.info.offset = offset;
+	resource_binding.info.range  = range;
+
+	update_resource_binding(resource_binding);
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	auto &resource_binding = get_resource_binding(binding, array_element);
 
-	dirty = true;
+	resource_binding.info.image_view = &image_view;
+	resource_binding.info.sampler    = &sampler;
+
+	update_resource_binding(resource_binding);
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	auto &resource_binding = get_resource_binding(binding, array_element);
 
-	dirty = true;
+	resource_binding.info.image_view = &image_view;
+	resource_binding.info.sampler    = nullptr;
+
+	update_resource_binding(resource_binding);
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	auto &resource_binding = get_resource_binding(binding, array_element);
 
-	dirty = true;
+	resource_binding.info.image_view = &image_view;
+
+	update_resource_binding(resource_binding);
+}
+
+bool ResourceSet::empty() const
+{
+	return resource_bindings.empty();
 }
 
-const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
+const std::vector<ResourceBinding> &ResourceSet::get_resource_bindings() const
 {
 	return resource_bindings;
 }
 
+ResourceBinding &ResourceSet::get_resource_binding(uint32_t binding, uint32_t array_element)
+{
+	// Sets only have a handful of bindings, a linear search over a contiguous table is the fastest lookup
+	auto it = std::find_if(resource_bindings.begin(), resource_bindings.end(), [binding, array_element](const ResourceBinding &resource_binding) {
+		return resource_binding.binding > binding || (resource_binding.binding == binding && resource_binding.array_element >= array_element);
+	});
+
+	if (it == resource_bindings.end() || it->binding != binding || it->array_element != array_element)
+	{
+		ResourceBinding resource_binding{};
+		resource_binding.binding       = binding;
+		resource_binding.array_element = array_element;
+
+		it = resource_bindings.insert(it, resource_binding);
+	}
+
+	return *it;
+}
+
+void ResourceSet::update_resource_binding(ResourceBinding &resource_binding)
+{
+	const auto &info = resource_binding.info;
+
+	resource_binding.hash = 0;
+	hash_combine(resource_binding.hash, resource_binding.binding);
+	hash_combine(resource_binding.hash, resource_binding.array_element);
+	hash_combine(resource_binding.hash, info.buffer ? info.buffer->get_handle() : VK_NULL_HANDLE);
+	hash_combine(resource_binding.hash, info.range);
+	hash_combine(resource_binding.hash, info.image_view ? info.image_view->get_handle() : VK_NULL_HANDLE);
+	hash_combine(resource_binding.hash, info.sampler ? info.sampler->get_handle() : VK_NULL_HANDLE);
+
+	resource_binding.info.dirty = true;
+
+	dirty = true;
+}
+
 }        // namespace vkb
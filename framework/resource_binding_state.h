@@ -44,11 +44,28 @@ struct ResourceInfo
 	const core::Sampler *sampler{nullptr};
 };
 
+/**
+ * @brief The resource bound to an element of a binding, with a hash of both kept up to date on every bind.
+ */
+struct ResourceBinding
+{
+	uint32_t binding{0};
+
+	uint32_t array_element{0};
+
+	ResourceInfo info;
+
+	/// Hash of the binding, the array element and the resource, except the buffer offset
+	/// which is left out of the descriptor set for dynamic buffers
+	size_t hash{0};
+};
+
 /**
  * @brief A resource set is a set of bindings containing resources that were bound 
  *        by a command buffer.
  *
- * The ResourceSet has a one to one mapping with a DescriptorSet.
+ * The ResourceSet has a one to one mapping with a DescriptorSet. Bindings are stored in a flat
+ * table sorted by binding and array element, which keeps its storage when the set is reset.
  */
 class ResourceSet
 {
@@ -69,12 +86,24 @@ class ResourceSet
 
 	void bind_input(const core::ImageView &image_view, uint32_t binding, uint32_t array_element);
 
-	const BindingMap<ResourceInfo> &get_resource_bindings() const;
+	bool empty() const;
+
+	const std::vector<ResourceBinding> &get_resource_bindings() const;
 
   private:
+	/**
+	 * @brief Finds the entry of an element of a binding, creating it if it was never bound
+	 */
+	ResourceBinding &get_resource_binding(uint32_t binding, uint32_t array_element);
+
+	/**
+	 * @brief Marks an entry as dirty and updates its hash after its resource changed
+	 */
+	void update_resource_binding(ResourceBinding &resource_binding);
+
 	bool dirty{false};
 
-	BindingMap<ResourceInfo> resource_bindings;
+	std::vector<ResourceBinding> resource_bindings;
 };
 
 /**
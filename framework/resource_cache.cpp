@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,6 +17,11 @@
 
 #include "resource_cache.h"
 
+#include <future>
+#include <thread>
+
+#include <ctpl_stl.h>
+
 #include "common/resource_caching.h"
 #include "core/device.h"
 
@@ -63,6 +68,88 @@ ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage,
 	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
 }
 
+std::vector<ShaderModule *> ResourceCache::request_shader_modules(const std::vector<ShaderModuleRequest> &requests)
+{
+	std::string entry_point{"main"};
+
+	std::vector<std::size_t> hashes(requests.size(), 0U);
+
+	// Indices of the first request for every shader module which is not cached yet
+	std::vector<size_t> missing_requests;
+
+	{
+		std::lock_guard<std::mutex> guard(shader_module_mutex);
+
+		std::unordered_set<std::size_t> missing_hashes;
+
+		for (size_t i = 0; i < requests.size(); ++i)
+		{
+			auto &request = requests[i];
+
+			hash_param(hashes[i], request.stage, request.glsl_source, entry_point, request.shader_variant);
+
+			if (state.shader_modules.find(hashes[i]) == state.shader_modules.end() && missing_hashes.insert(hashes[i]).second)
+			{
+				missing_requests.push_back(i);
+			}
+		}
+	}
+
+	if (!missing_requests.empty())
+	{
+		auto thread_count = std::thread::hardware_concurrency();
+		thread_count      = thread_count == 0 ? 1 : thread_count;
+		thread_count      = std::min(thread_count, to_u32(missing_requests.size()));
+		ctpl::thread_pool thread_pool(thread_count);
+
+		// Compilation does not touch the cache, so it can run without holding the mutex
+		std::vector<std::future<ShaderModule>> shader_module_futures;
+		for (auto request_index : missing_requests)
+		{
+			auto fut = thread_pool.push(
+			    [this, &requests, &entry_point, request_index](size_t) {
+				    auto &request = requests[request_index];
+
+				    return ShaderModule{device, request.stage, request.glsl_source, entry_point, request.shader_variant};
+			    });
+
+			shader_module_futures.push_back(std::move(fut));
+		}
+
+		for (size_t i = 0; i < missing_requests.size(); ++i)
+		{
+			auto  request_index = missing_requests[i];
+			auto &request       = requests[request_index];
+
+			auto shader_module = shader_module_futures[i].get();
+
+			std::lock_guard<std::mutex> guard(shader_module_mutex);
+
+			LOGD("Building #{} cache object ({})", state.shader_modules.size(), typeid(ShaderModule).name());
+
+			auto res_ins_it = state.shader_modules.emplace(hashes[request_index], std::move(shader_module));
+
+			// Another thread may have built the same module in the meantime, in which case it is already recorded
+			if (res_ins_it.second)
+			{
+				size_t index = recorder.register_shader_module(request.stage, request.glsl_source, entry_point, request.shader_variant);
+				recorder.set_shader_module(index, res_ins_it.first->second);
+			}
+		}
+	}
+
+	std::vector<ShaderModule *> shader_modules(requests.size());
+
+	std::lock_guard<std::mutex> guard(shader_module_mutex);
+
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		shader_modules[i] = &state.shader_modules.at(hashes[i]);
+	}
+
+	return shader_modules;
+}
+
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
 	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -39,6 +39,18 @@ namespace core
 class ImageView;
 }
 
+/**
+ * @brief Describes a shader module to be built as part of a batch by ResourceCache::request_shader_modules
+ */
+struct ShaderModuleRequest
+{
+	VkShaderStageFlagBits stage;
+
+	const ShaderSource &glsl_source;
+
+	const ShaderVariant &shader_variant;
+};
+
 /**
  * @brief Struct to hold the internal state of the Resource Cache
  *
@@ -97,6 +109,15 @@ class ResourceCache
 
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
+	/**
+	 * @brief Requests a batch of shader modules at once
+	 *        Requests are deduplicated, and the modules missing from the cache are compiled
+	 *        in parallel on a thread pool before being inserted into the cache
+	 * @param requests The shader modules to build
+	 * @return The shader modules, in the same order as the requests
+	 */
+	std::vector<ShaderModule *> request_shader_modules(const std::vector<ShaderModuleRequest> &requests);
+
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
 
 	DescriptorSetLayout &request_descriptor_set_layout(const uint32_t                     set_index,
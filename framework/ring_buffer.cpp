@@ -0,0 +1,193 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ring_buffer.h"
+
+#include "common/logging.h"
+#include "common/strings.h"
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+inline VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+}        // namespace
+
+RingBuffer::RingBuffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    device{device},
+    usage{usage},
+    memory_usage{memory_usage},
+    alignment{get_buffer_offset_alignment(device, usage)}
+{
+	// Keep the size a multiple of the alignment, so that wrapping around keeps offsets aligned
+	min_size = align_up(size, alignment);
+	buffer   = std::make_unique<core::Buffer>(device, min_size, usage, memory_usage);
+}
+
+void RingBuffer::begin_frame(const RenderFrame &frame)
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	if (active_frame)
+	{
+		frame_heads[active_frame] = head;
+	}
+
+	active_frame = &frame;
+
+	// The frame fences were waited, so everything allocated up to the end of its previous use was consumed
+	auto it = frame_heads.find(&frame);
+	if (it != frame_heads.end())
+	{
+		tail = std::max(tail, it->second);
+	}
+
+	// Release the buffers no frame in flight may use anymore
+	for (auto retired_it = retired_buffers.begin(); retired_it != retired_buffers.end();)
+	{
+		retired_it->second.erase(&frame);
+
+		if (retired_it->second.empty())
+		{
+			retired_it = retired_buffers.erase(retired_it);
+		}
+		else
+		{
+			++retired_it;
+		}
+	}
+
+	if (shrink_window > 0 && ++window_frame_count >= shrink_window)
+	{
+		VkDeviceSize size = buffer->get_size();
+
+		if (window_high_water_mark < size / 4 && size / 2 >= min_size)
+		{
+			LOGD("Shrinking {} ring buffer from {} KB to {} KB", buffer_usage_to_string(usage), size / 1024, size / 2048);
+			resize(size / 2);
+		}
+
+		window_high_water_mark = 0;
+		window_frame_count     = 0;
+	}
+}
+
+BufferAllocation RingBuffer::allocate(const uint32_t size)
+{
+	assert(size > 0 && "Allocation size must be greater than zero");
+
+	std::lock_guard<std::mutex> guard{mutex};
+
+	if (size > buffer->get_size())
+	{
+		resize(align_up(2 * static_cast<VkDeviceSize>(size), alignment));
+	}
+
+	while (true)
+	{
+		VkDeviceSize ring_size = buffer->get_size();
+		VkDeviceSize start     = align_up(head, alignment);
+		VkDeviceSize offset    = start % ring_size;
+
+		// An allocation cannot wrap around the end of the ring
+		if (offset + size > ring_size)
+		{
+			start += ring_size - offset;
+			offset = 0;
+		}
+
+		if (start + size - tail > ring_size)
+		{
+			// The frames in flight still use the whole ring
+			LOGD("Growing {} ring buffer from {} KB to {} KB", buffer_usage_to_string(usage), ring_size / 1024, ring_size / 512);
+			resize(2 * ring_size);
+			continue;
+		}
+
+		head = start + size;
+
+		high_water_mark        = std::max(high_water_mark, head - tail);
+		window_high_water_mark = std::max(window_high_water_mark, head - tail);
+
+		return BufferAllocation{*buffer, size, offset};
+	}
+}
+
+void RingBuffer::set_shrink_window(uint32_t frame_window)
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	shrink_window          = frame_window;
+	window_high_water_mark = 0;
+	window_frame_count     = 0;
+}
+
+VkDeviceSize RingBuffer::get_size() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return buffer->get_size();
+}
+
+VkDeviceSize RingBuffer::get_used_size() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return head - tail;
+}
+
+VkDeviceSize RingBuffer::get_high_water_mark() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return high_water_mark;
+}
+
+void RingBuffer::resize(VkDeviceSize new_size)
+{
+	// Every frame which allocated from the current buffer has to start again before it is released
+	std::set<const RenderFrame *> pending_frames;
+	for (auto &frame_head : frame_heads)
+	{
+		pending_frames.insert(frame_head.first);
+	}
+	if (active_frame)
+	{
+		pending_frames.insert(active_frame);
+	}
+
+	if (pending_frames.empty())
+	{
+		// Nothing was allocated from a frame yet, the buffer can go straight away
+		buffer.reset();
+	}
+	else
+	{
+		retired_buffers.emplace_back(std::move(buffer), std::move(pending_frames));
+	}
+
+	buffer = std::make_unique<core::Buffer>(device, new_size, usage, memory_usage);
+
+	head = 0;
+	tail = 0;
+	frame_heads.clear();
+}
+}        // namespace vkb
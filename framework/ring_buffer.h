@@ -0,0 +1,134 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+
+#include "buffer_pool.h"
+#include "common/helpers.h"
+#include "core/buffer.h"
+
+namespace vkb
+{
+class Device;
+class RenderFrame;
+
+/**
+ * @brief A persistent buffer, shared by all the frames in flight, which per-frame data is streamed through.
+ *
+ * Allocations are written at the head of the ring, and the tail is moved forward when a frame
+ * starts again, as its fence guarantees that the data allocated during its previous use was consumed.
+ * Contrary to a BufferPool, memory is reclaimed frame by frame, so a spiky frame does not grow the
+ * footprint of all the frames in flight.
+ *
+ * When the ring is full it is replaced by a buffer twice its size; the previous buffer is kept alive
+ * until all the frames which may use it have completed. With shrinking enabled, the ring is halved
+ * again when its usage stays low for a while.
+ */
+class RingBuffer
+{
+  public:
+	RingBuffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+	RingBuffer(const RingBuffer &) = delete;
+
+	RingBuffer(RingBuffer &&) = delete;
+
+	RingBuffer &operator=(const RingBuffer &) = delete;
+
+	RingBuffer &operator=(RingBuffer &&) = delete;
+
+	/**
+	 * @brief Reclaims the memory allocated the last time the frame was in flight
+	 *        It must be called once the fences of the frame were waited, RenderFrame::reset does it
+	 * @param frame The frame starting
+	 */
+	void begin_frame(const RenderFrame &frame);
+
+	/**
+	 * @brief Allocates memory at the head of the ring, it can be called from multiple threads
+	 * @param size Amount of memory required
+	 * @return The requested allocation
+	 */
+	BufferAllocation allocate(uint32_t size);
+
+	/**
+	 * @brief Allows the ring to shrink back when its usage stays below a quarter of its size
+	 * @param frame_window Number of frames the usage is observed for before shrinking, 0 disables shrinking
+	 */
+	void set_shrink_window(uint32_t frame_window);
+
+	/**
+	 * @return The size of the ring
+	 */
+	VkDeviceSize get_size() const;
+
+	/**
+	 * @return The amount of memory currently allocated by the frames in flight
+	 */
+	VkDeviceSize get_used_size() const;
+
+	/**
+	 * @return The highest amount of memory allocated by the frames in flight since the ring was created
+	 */
+	VkDeviceSize get_high_water_mark() const;
+
+  private:
+	/**
+	 * @brief Replaces the ring with a new buffer, the current one is released once the frames in flight completed
+	 */
+	void resize(VkDeviceSize new_size);
+
+	Device &device;
+
+	VkBufferUsageFlags usage;
+
+	VmaMemoryUsage memory_usage;
+
+	VkDeviceSize alignment{0};
+
+	/// The initial size, the ring never shrinks below it
+	VkDeviceSize min_size{0};
+
+	std::unique_ptr<core::Buffer> buffer;
+
+	/// Buffers replaced by a resize, with the frames which have to start again before they can be destroyed
+	std::vector<std::pair<std::unique_ptr<core::Buffer>, std::set<const RenderFrame *>>> retired_buffers;
+
+	/// Monotonic offsets, the physical offset is obtained modulo the size of the ring
+	VkDeviceSize head{0};
+
+	VkDeviceSize tail{0};
+
+	/// Head of the ring at the end of the last use of each frame
+	std::unordered_map<const RenderFrame *, VkDeviceSize> frame_heads;
+
+	const RenderFrame *active_frame{nullptr};
+
+	VkDeviceSize high_water_mark{0};
+
+	uint32_t shrink_window{0};
+
+	/// Highest usage and number of frames observed in the current shrink window
+	VkDeviceSize window_high_water_mark{0};
+
+	uint32_t window_frame_count{0};
+
+	mutable std::mutex mutex;
+};
+}        // namespace vkb
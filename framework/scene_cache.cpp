@@ -0,0 +1,497 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene_cache.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "common/error.h"
+#include "common/helpers.h"
+#include "common/logging.h"
+
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <Windows.h>
+#endif
+
+namespace vkb
+{
+namespace
+{
+const char MAGIC[8] = {'V', 'K', 'B', 'S', 'C', 'E', 'N', 'E'};
+
+// Increase when the layout of the records changes, older caches are then rebuilt
+const uint32_t VERSION = 1;
+
+struct Header
+{
+	char magic[8];
+
+	uint32_t version;
+
+	uint32_t reserved;
+
+	uint64_t source_hash;
+};
+
+struct Footer
+{
+	uint64_t table_offset;
+
+	char magic[8];
+};
+
+inline uint64_t hash_bytes(const void *data, size_t size, uint64_t hash)
+{
+	// FNV-1a
+	auto bytes = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+template <typename T>
+inline uint64_t hash_value(const T &value, uint64_t hash)
+{
+	return hash_bytes(&value, sizeof(T), hash);
+}
+
+/**
+ * @brief Reads the records of a cache, throws if they overrun the file
+ */
+class Reader
+{
+  public:
+	Reader(const fs::FileData &file, uint64_t offset) :
+	    file{file},
+	    offset{offset}
+	{}
+
+	template <typename T>
+	T read()
+	{
+		T value;
+		std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	const uint8_t *read_bytes(uint64_t size)
+	{
+		if (offset > file.size() || size > file.size() - offset)
+		{
+			throw std::runtime_error{"Scene cache is truncated"};
+		}
+
+		auto data = file.data() + offset;
+		offset += size;
+		return data;
+	}
+
+	std::string read_string()
+	{
+		auto size = read<uint32_t>();
+		auto data = read_bytes(size);
+		return std::string{reinterpret_cast<const char *>(data), size};
+	}
+
+	std::vector<uint8_t> read_vector()
+	{
+		auto size = read<uint64_t>();
+		auto data = read_bytes(size);
+		return std::vector<uint8_t>{data, data + size};
+	}
+
+  private:
+	const fs::FileData &file;
+
+	uint64_t offset;
+};
+
+/**
+ * @brief An image restored from a cache, with the format it was decoded to
+ */
+class CachedImage : public sg::Image
+{
+  public:
+	CachedImage(const std::string &name, std::vector<uint8_t> &&data, std::vector<sg::Mipmap> &&mipmaps,
+	            VkFormat format, uint32_t layers, const std::vector<std::vector<VkDeviceSize>> &offsets) :
+	    Image{name, std::move(data), std::move(mipmaps)}
+	{
+		set_format(format);
+		set_layers(layers);
+		set_offsets(offsets);
+	}
+
+	virtual ~CachedImage() = default;
+};
+
+/**
+ * @brief Moves a file over another one in a single step, so that there is always a complete file at the destination
+ */
+inline bool replace_file(const std::string &from, const std::string &to)
+{
+#if defined(_WIN32)
+	// std::rename fails on Windows when the destination exists
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+}        // namespace
+
+uint64_t SceneCache::hash_source(const fs::FileData &gltf_data, const std::string &base_dir, uint64_t salt)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	hash = hash_value(VERSION, hash);
+	hash = hash_value(salt, hash);
+	hash = hash_bytes(gltf_data.data(), gltf_data.size(), hash);
+
+	auto json = nlohmann::json::parse(gltf_data.begin(), gltf_data.end(), nullptr, false);
+	if (json.is_discarded())
+	{
+		return hash;
+	}
+
+	// Hashing the content of the referenced files would cost as much as reading them
+	for (auto *array_name : {"buffers", "images"})
+	{
+		auto array = json.find(array_name);
+		if (array == json.end() || !array->is_array())
+		{
+			continue;
+		}
+
+		for (auto &element : *array)
+		{
+			auto uri = element.find("uri");
+			if (uri == element.end() || !uri->is_string())
+			{
+				continue;
+			}
+
+			auto uri_string = uri->get<std::string>();
+			if (uri_string.compare(0, 5, "data:") == 0)
+			{
+				// Embedded data is part of the glTF file
+				continue;
+			}
+
+			hash = hash_bytes(uri_string.data(), uri_string.size(), hash);
+
+			struct stat info;
+			if (stat((base_dir + "/" + uri_string).c_str(), &info) == 0)
+			{
+				hash = hash_value(static_cast<uint64_t>(info.st_size), hash);
+				hash = hash_value(static_cast<uint64_t>(info.st_mtime), hash);
+			}
+		}
+	}
+
+	return hash;
+}
+
+std::shared_ptr<const SceneCache> SceneCache::open(const std::string &name, uint64_t source_hash)
+{
+	if (!fs::is_file(fs::path::get(fs::path::Type::Temp) + name))
+	{
+		return nullptr;
+	}
+
+	try
+	{
+		std::shared_ptr<SceneCache> cache{new SceneCache{fs::map_temp(name)}};
+
+		auto &file = cache->file;
+
+		if (file.size() < sizeof(Header) + sizeof(Footer))
+		{
+			throw std::runtime_error{"Scene cache is truncated"};
+		}
+
+		Header header;
+		std::memcpy(&header, file.data(), sizeof(Header));
+
+		Footer footer;
+		std::memcpy(&footer, file.end() - sizeof(Footer), sizeof(Footer));
+
+		if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || std::memcmp(footer.magic, MAGIC, sizeof(MAGIC)) != 0)
+		{
+			throw std::runtime_error{"Invalid scene cache"};
+		}
+
+		if (header.version != VERSION || header.source_hash != source_hash)
+		{
+			LOGI("Scene cache {} is stale", name);
+			return nullptr;
+		}
+
+		Reader reader{file, footer.table_offset};
+
+		auto read_offsets = [&](std::vector<uint64_t> &offsets) {
+			offsets.resize(static_cast<size_t>(reader.read<uint64_t>()));
+			for (auto &offset : offsets)
+			{
+				offset = reader.read<uint64_t>();
+				if (offset < sizeof(Header) || offset >= footer.table_offset)
+				{
+					throw std::runtime_error{"Invalid scene cache record"};
+				}
+			}
+		};
+
+		read_offsets(cache->image_offsets);
+		read_offsets(cache->mesh_offsets);
+
+		return cache;
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Ignoring scene cache {}: {}", name, e.what());
+		return nullptr;
+	}
+}
+
+SceneCache::SceneCache(fs::FileData &&file) :
+    file{std::move(file)}
+{
+}
+
+size_t SceneCache::get_image_count() const
+{
+	return image_offsets.size();
+}
+
+size_t SceneCache::get_mesh_count() const
+{
+	return mesh_offsets.size();
+}
+
+std::unique_ptr<sg::Image> SceneCache::read_image(size_t index) const
+{
+	Reader reader{file, image_offsets.at(index)};
+
+	auto name   = reader.read_string();
+	auto format = static_cast<VkFormat>(reader.read<uint32_t>());
+	auto layers = reader.read<uint32_t>();
+
+	std::vector<sg::Mipmap> mipmaps(reader.read<uint32_t>());
+	for (auto &mipmap : mipmaps)
+	{
+		mipmap.level         = reader.read<uint32_t>();
+		mipmap.offset        = reader.read<uint32_t>();
+		mipmap.extent.width  = reader.read<uint32_t>();
+		mipmap.extent.height = reader.read<uint32_t>();
+		mipmap.extent.depth  = reader.read<uint32_t>();
+	}
+
+	std::vector<std::vector<VkDeviceSize>> offsets(reader.read<uint32_t>());
+	for (auto &layer_offsets : offsets)
+	{
+		layer_offsets.resize(reader.read<uint32_t>());
+		for (auto &offset : layer_offsets)
+		{
+			offset = reader.read<uint64_t>();
+		}
+	}
+
+	auto data = reader.read_vector();
+
+	return std::make_unique<CachedImage>(name, std::move(data), std::move(mipmaps), format, layers, offsets);
+}
+
+std::vector<PrimitiveData> SceneCache::read_mesh(size_t index) const
+{
+	Reader reader{file, mesh_offsets.at(index)};
+
+	std::vector<PrimitiveData> primitives(reader.read<uint32_t>());
+	for (auto &primitive : primitives)
+	{
+		primitive.attributes.resize(reader.read<uint32_t>());
+		for (auto &attribute : primitive.attributes)
+		{
+			attribute.name             = reader.read_string();
+			attribute.attribute.format = static_cast<VkFormat>(reader.read<uint32_t>());
+			attribute.attribute.stride = reader.read<uint32_t>();
+			attribute.attribute.offset = reader.read<uint32_t>();
+			attribute.data             = reader.read_vector();
+		}
+
+		primitive.vertices_count = reader.read<uint32_t>();
+		primitive.has_indices    = reader.read<uint32_t>() != 0;
+		primitive.index_data     = reader.read_vector();
+		primitive.vertex_indices = reader.read<uint32_t>();
+		primitive.index_type     = static_cast<VkIndexType>(reader.read<uint32_t>());
+	}
+
+	return primitives;
+}
+
+SceneCacheWriter::SceneCacheWriter(const std::string &name, uint64_t source_hash) :
+    path{fs::path::get(fs::path::Type::Temp) + name}
+{
+	// Written aside, so that an interrupted load does not leave a truncated cache behind
+	stream.open(path + ".tmp", std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!stream.is_open())
+	{
+		LOGW("Cannot write scene cache {}", path);
+		return;
+	}
+
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version     = VERSION;
+	header.source_hash = source_hash;
+
+	write_value(header);
+}
+
+SceneCacheWriter::~SceneCacheWriter()
+{
+	if (stream.is_open())
+	{
+		stream.close();
+		std::remove((path + ".tmp").c_str());
+	}
+}
+
+void SceneCacheWriter::write_image(const sg::Image &image)
+{
+	image_offsets.push_back(offset);
+
+	write_string(image.get_name());
+	write_value(static_cast<uint32_t>(image.get_format()));
+	write_value(image.get_layers());
+
+	write_value(to_u32(image.get_mipmaps().size()));
+	for (auto &mipmap : image.get_mipmaps())
+	{
+		write_value(mipmap.level);
+		write_value(mipmap.offset);
+		write_value(mipmap.extent.width);
+		write_value(mipmap.extent.height);
+		write_value(mipmap.extent.depth);
+	}
+
+	write_value(to_u32(image.get_offsets().size()));
+	for (auto &layer_offsets : image.get_offsets())
+	{
+		write_value(to_u32(layer_offsets.size()));
+		for (auto layer_offset : layer_offsets)
+		{
+			write_value(static_cast<uint64_t>(layer_offset));
+		}
+	}
+
+	write_bytes(image.get_data().data(), image.get_data().size());
+}
+
+void SceneCacheWriter::write_mesh(const std::vector<PrimitiveData> &primitives)
+{
+	mesh_offsets.push_back(offset);
+
+	write_value(to_u32(primitives.size()));
+	for (auto &primitive : primitives)
+	{
+		write_value(to_u32(primitive.attributes.size()));
+		for (auto &attribute : primitive.attributes)
+		{
+			write_string(attribute.name);
+			write_value(static_cast<uint32_t>(attribute.attribute.format));
+			write_value(attribute.attribute.stride);
+			write_value(attribute.attribute.offset);
+			write_bytes(attribute.data.data(), attribute.data.size());
+		}
+
+		write_value(primitive.vertices_count);
+		write_value(static_cast<uint32_t>(primitive.has_indices));
+		write_bytes(primitive.index_data.data(), primitive.index_data.size());
+		write_value(primitive.vertex_indices);
+		write_value(static_cast<uint32_t>(primitive.index_type));
+	}
+}
+
+void SceneCacheWriter::close()
+{
+	if (!stream.is_open())
+	{
+		return;
+	}
+
+	Footer footer{};
+	footer.table_offset = offset;
+	std::memcpy(footer.magic, MAGIC, sizeof(MAGIC));
+
+	for (auto *offsets : {&image_offsets, &mesh_offsets})
+	{
+		write_value(static_cast<uint64_t>(offsets->size()));
+		for (auto record_offset : *offsets)
+		{
+			write_value(record_offset);
+		}
+	}
+
+	write_value(footer);
+
+	bool written = stream.good();
+	stream.close();
+
+	if (!written || !replace_file(path + ".tmp", path))
+	{
+		LOGW("Failed to write scene cache {}", path);
+		std::remove((path + ".tmp").c_str());
+		return;
+	}
+
+	LOGI("Wrote scene cache {} ({} MB)", path, offset / (1024 * 1024));
+}
+
+void SceneCacheWriter::write(const void *data, size_t size)
+{
+	if (stream.is_open())
+	{
+		stream.write(static_cast<const char *>(data), size);
+	}
+
+	offset += size;
+}
+
+template <typename T>
+void SceneCacheWriter::write_value(const T &value)
+{
+	write(&value, sizeof(T));
+}
+
+void SceneCacheWriter::write_string(const std::string &value)
+{
+	write_value(to_u32(value.size()));
+	write(value.data(), value.size());
+}
+
+void SceneCacheWriter::write_bytes(const uint8_t *data, size_t size)
+{
+	write_value(static_cast<uint64_t>(size));
+	write(data, size);
+}
+}        // namespace vkb
@@ -0,0 +1,158 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "platform/filesystem.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/sub_mesh.h"
+
+namespace vkb
+{
+/**
+ * @brief The geometry of a glTF primitive, as it is copied to the buffers of a submesh
+ */
+struct PrimitiveData
+{
+	struct Attribute
+	{
+		std::string name;
+
+		std::vector<uint8_t> data;
+
+		sg::VertexAttribute attribute;
+	};
+
+	std::vector<Attribute> attributes;
+
+	uint32_t vertices_count{0};
+
+	bool has_indices{false};
+
+	std::vector<uint8_t> index_data;
+
+	uint32_t vertex_indices{0};
+
+	VkIndexType index_type{};
+};
+
+/**
+ * @brief A binary cache of the data of a scene which is expensive to produce from its source files:
+ *        the images, decoded to the format they are uploaded in with their mip chains, and the geometry of the meshes.
+ *
+ * The cache lives in the temporary directory and is memory-mapped, so reading it is bounded by copying the data
+ * to the components of the scene. It is tied to a hash of its source, a cache built from other files is ignored.
+ */
+class SceneCache
+{
+  public:
+	/**
+	 * @brief Hashes the source of a scene: the content of its glTF file, and the size and modification time
+	 *        of the files it references, so that editing a texture invalidates the cache too
+	 * @param gltf_data The content of the glTF file
+	 * @param base_dir The directory the references are relative to
+	 * @param salt Settings which change how the source is converted
+	 */
+	static uint64_t hash_source(const fs::FileData &gltf_data, const std::string &base_dir, uint64_t salt);
+
+	/**
+	 * @brief Opens a scene cache
+	 * @param name The name of the cache in the temporary directory
+	 * @param source_hash The hash of the source the cache must have been built from
+	 * @return The cache, or nullptr if there is none or if it is stale or invalid
+	 */
+	static std::shared_ptr<const SceneCache> open(const std::string &name, uint64_t source_hash);
+
+	size_t get_image_count() const;
+
+	size_t get_mesh_count() const;
+
+	/**
+	 * @brief Reads an image, it can be called from multiple threads
+	 */
+	std::unique_ptr<sg::Image> read_image(size_t index) const;
+
+	/**
+	 * @brief Reads the primitives of a mesh, it can be called from multiple threads
+	 */
+	std::vector<PrimitiveData> read_mesh(size_t index) const;
+
+  private:
+	SceneCache(fs::FileData &&file);
+
+	fs::FileData file;
+
+	/// Offsets of the records in the file
+	std::vector<uint64_t> image_offsets;
+
+	std::vector<uint64_t> mesh_offsets;
+};
+
+/**
+ * @brief Writes a scene cache as the scene is loaded
+ *
+ * Images and meshes are written in the order of the glTF file, as soon as they are available, so that the loader
+ * does not need to keep their data around. The cache only replaces the previous one once it is complete.
+ */
+class SceneCacheWriter
+{
+  public:
+	/**
+	 * @brief Starts writing a scene cache
+	 * @param name The name of the cache in the temporary directory
+	 * @param source_hash The hash of the source of the scene
+	 */
+	SceneCacheWriter(const std::string &name, uint64_t source_hash);
+
+	~SceneCacheWriter();
+
+	void write_image(const sg::Image &image);
+
+	void write_mesh(const std::vector<PrimitiveData> &primitives);
+
+	/**
+	 * @brief Completes the cache, so that the next loads of the scene find it
+	 */
+	void close();
+
+  private:
+	void write(const void *data, size_t size);
+
+	template <typename T>
+	void write_value(const T &value);
+
+	void write_string(const std::string &value);
+
+	void write_bytes(const uint8_t *data, size_t size);
+
+	std::string path;
+
+	std::ofstream stream;
+
+	uint64_t offset{0};
+
+	std::vector<uint64_t> image_offsets;
+
+	std::vector<uint64_t> mesh_offsets;
+};
+}        // namespace vkb
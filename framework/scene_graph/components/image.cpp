@@ -17,6 +17,7 @@
 
 #include "image.h"
 
+#include <cmath>
 #include <mutex>
 
 #include "common/error.h"
@@ -32,6 +33,8 @@ VKBP_ENABLE_WARNINGS()
 #include "scene_graph/components/image/ktx.h"
 #include "scene_graph/components/image/stb.h"
 
+#include <ctpl_stl.h>
+
 namespace vkb
 {
 namespace sg
@@ -68,6 +71,150 @@ bool is_astc(const VkFormat format)
 	        format == VK_FORMAT_ASTC_12x12_SRGB_BLOCK);
 }
 
+// Levels with fewer rows than this are filtered by a single thread
+static const uint32_t MIN_MIPMAP_ROWS_PER_THREAD = 64;
+
+// Whether the current thread is one of several threads processing images at once
+static thread_local bool image_worker_thread = false;
+
+static ctpl::thread_pool &get_row_thread_pool()
+{
+	// Created on first use and shared, so that processing an image does not spawn threads each time
+	static ctpl::thread_pool thread_pool(std::max(1u, std::thread::hardware_concurrency()));
+	return thread_pool;
+}
+
+void process_rows_in_parallel(uint32_t row_count, uint32_t min_rows_per_thread, const std::function<void(uint32_t, uint32_t)> &process_rows)
+{
+	auto thread_count = std::thread::hardware_concurrency();
+	thread_count      = thread_count == 0 ? 1 : thread_count;
+	thread_count      = std::min(thread_count, std::max(1u, row_count / std::max(1u, min_rows_per_thread)));
+
+	if (image_worker_thread || thread_count == 1)
+	{
+		process_rows(0, row_count);
+		return;
+	}
+
+	auto &thread_pool     = get_row_thread_pool();
+	auto  rows_per_thread = (row_count + thread_count - 1) / thread_count;
+
+	std::vector<std::future<void>> row_futures;
+	for (uint32_t first_row = 0; first_row < row_count; first_row += rows_per_thread)
+	{
+		auto last_row = std::min(first_row + rows_per_thread, row_count);
+
+		row_futures.push_back(thread_pool.push([&process_rows, first_row, last_row](size_t) { process_rows(first_row, last_row); }));
+	}
+
+	for (auto &row_future : row_futures)
+	{
+		row_future.get();
+	}
+}
+
+ImageWorkerScope::ImageWorkerScope() :
+    previous{image_worker_thread}
+{
+	image_worker_thread = true;
+}
+
+ImageWorkerScope::~ImageWorkerScope()
+{
+	image_worker_thread = previous;
+}
+
+static bool is_srgb(VkFormat format)
+{
+	switch (format)
+	{
+		case VK_FORMAT_R8G8B8A8_SRGB:
+		case VK_FORMAT_B8G8R8A8_SRGB:
+		case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Conversions between sRGB encoded texels and linear values, so that sRGB images are filtered in linear space
+struct SrgbTables
+{
+	float to_linear[256];
+
+	// Indexed by a linear value scaled to [0, 4095]
+	uint8_t to_srgb[4096];
+};
+
+static const SrgbTables &get_srgb_tables()
+{
+	static const SrgbTables tables = [] {
+		SrgbTables result;
+
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			float c             = i / 255.0f;
+			result.to_linear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+
+		for (uint32_t i = 0; i < 4096; i++)
+		{
+			float l           = i / 4095.0f;
+			float c           = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+			result.to_srgb[i] = static_cast<uint8_t>(std::min(255.0f, c * 255.0f + 0.5f));
+		}
+
+		return result;
+	}();
+
+	return tables;
+}
+
+/**
+ * @brief Averages 2x2 texels of an RGBA8 level into the rows [first_row, last_row) of the next level
+ *        The source level has to be exactly twice the size of the destination in both dimensions
+ */
+static void downsample_box_rgba8(const uint8_t *src, uint8_t *dst, uint32_t dst_width, uint32_t first_row, uint32_t last_row, bool srgb)
+{
+	const uint32_t src_pitch = dst_width * 8;
+	const uint32_t dst_pitch = dst_width * 4;
+
+	for (uint32_t y = first_row; y < last_row; y++)
+	{
+		const uint8_t *row0 = src + 2 * y * src_pitch;
+		const uint8_t *row1 = row0 + src_pitch;
+		uint8_t       *out  = dst + y * dst_pitch;
+
+		if (!srgb)
+		{
+			// A branchless loop over bytes, which compilers vectorize
+			for (uint32_t i = 0; i < dst_pitch; i++)
+			{
+				uint32_t s = ((i >> 2) << 3) | (i & 3);
+				out[i]     = static_cast<uint8_t>((row0[s] + row0[s + 4] + row1[s] + row1[s + 4] + 2) >> 2);
+			}
+			continue;
+		}
+
+		auto &tables = get_srgb_tables();
+
+		for (uint32_t x = 0; x < dst_width; x++)
+		{
+			const uint8_t *t0 = row0 + x * 8;
+			const uint8_t *t1 = row1 + x * 8;
+
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				float linear   = tables.to_linear[t0[c]] + tables.to_linear[t0[c + 4]] + tables.to_linear[t1[c]] + tables.to_linear[t1[c + 4]];
+				out[x * 4 + c] = tables.to_srgb[static_cast<uint32_t>(linear * (4095.0f / 4.0f) + 0.5f)];
+			}
+
+			// Alpha is stored linearly
+			out[x * 4 + 3] = static_cast<uint8_t>((t0[3] + t0[7] + t1[3] + t1[7] + 2) >> 2);
+		}
+	}
+}
+
 // When the color-space of a loaded image is unknown (from KTX1 for example) we
 // may want to assume that the loaded data is in sRGB format (since it usually is).
 // In those cases, this helper will get called which will force an existing unorm
@@ -245,40 +392,63 @@ void Image::generate_mipmaps()
 		return;        // Do not generate again
 	}
 
-	auto extent      = get_extent();
-	auto next_width  = std::max<uint32_t>(1u, extent.width / 2);
-	auto next_height = std::max<uint32_t>(1u, extent.height / 2);
-	auto channels    = 4;
-	auto next_size   = next_width * next_height * channels;
+	auto     extent   = get_extent();
+	uint32_t channels = 4;
 
-	while (true)
+	// Compute the whole chain first, so that the data is allocated once
+	auto width  = extent.width;
+	auto height = extent.height;
+	auto size   = to_u32(data.size());
+	while (width > 1 || height > 1)
 	{
-		// Make space for next mipmap
-		auto old_size = to_u32(data.size());
-		data.resize(old_size + next_size);
+		width  = std::max<uint32_t>(1u, width / 2);
+		height = std::max<uint32_t>(1u, height / 2);
 
-		auto &prev_mipmap = mipmaps.back();
-		// Update mipmaps
 		Mipmap next_mipmap{};
-		next_mipmap.level  = prev_mipmap.level + 1;
-		next_mipmap.offset = old_size;
-		next_mipmap.extent = {next_width, next_height, 1u};
+		next_mipmap.level  = mipmaps.back().level + 1;
+		next_mipmap.offset = size;
+		next_mipmap.extent = {width, height, 1u};
+
+		mipmaps.push_back(next_mipmap);
+
+		size += width * height * channels;
+	}
 
-		// Fill next mipmap memory
-		stbir_resize_uint8(data.data() + prev_mipmap.offset, prev_mipmap.extent.width, prev_mipmap.extent.height, 0,
-		                   data.data() + next_mipmap.offset, next_mipmap.extent.width, next_mipmap.extent.height, 0, channels);
+	data.resize(size);
 
-		mipmaps.emplace_back(std::move(next_mipmap));
+	bool srgb = is_srgb(format);
 
-		// Next mipmap values
-		next_width  = std::max<uint32_t>(1u, next_width / 2);
-		next_height = std::max<uint32_t>(1u, next_height / 2);
-		next_size   = next_width * next_height * channels;
+	// Large levels are split across threads by rows, the levels themselves depend on each other
+	for (size_t i = 1; i < mipmaps.size(); i++)
+	{
+		auto &prev_mipmap = mipmaps[i - 1];
+		auto &next_mipmap = mipmaps[i];
+
+		const uint8_t *src = data.data() + prev_mipmap.offset;
+		uint8_t       *dst = data.data() + next_mipmap.offset;
 
-		if (next_width == 1 && next_height == 1)
+		// Levels which halve both dimensions are averaged 2x2 texels at a time, the others are resampled
+		if (prev_mipmap.extent.width != 2 * next_mipmap.extent.width ||
+		    prev_mipmap.extent.height != 2 * next_mipmap.extent.height)
 		{
-			break;
+			if (srgb)
+			{
+				stbir_resize_uint8_srgb(src, prev_mipmap.extent.width, prev_mipmap.extent.height, 0,
+				                        dst, next_mipmap.extent.width, next_mipmap.extent.height, 0, channels, 3, 0);
+			}
+			else
+			{
+				stbir_resize_uint8(src, prev_mipmap.extent.width, prev_mipmap.extent.height, 0,
+				                   dst, next_mipmap.extent.width, next_mipmap.extent.height, 0, channels);
+			}
+			continue;
 		}
+
+		auto dst_width = next_mipmap.extent.width;
+
+		process_rows_in_parallel(next_mipmap.extent.height, MIN_MIPMAP_ROWS_PER_THREAD, [src, dst, dst_width, srgb](uint32_t first_row, uint32_t last_row) {
+			downsample_box_rgba8(src, dst, dst_width, first_row, last_row, srgb);
+		});
 	}
 }
 
@@ -341,26 +511,27 @@ std::unique_ptr<Image> Image::load(const std::string &name, const std::string &u
 {
 	std::unique_ptr<Image> image{nullptr};
 
-	auto data = fs::read_asset(uri);
+	// The decoders copy what they keep, so the file is only mapped while they run
+	auto data = fs::map_asset(uri);
 
 	// Get extension
 	auto extension = get_extension(uri);
 
 	if (extension == "png" || extension == "jpg")
 	{
-		image = std::make_unique<Stb>(name, data, content_type);
+		image = std::make_unique<Stb>(name, data.data(), data.size(), content_type);
 	}
 	else if (extension == "astc")
 	{
-		image = std::make_unique<Astc>(name, data);
+		image = std::make_unique<Astc>(name, data.data(), data.size());
 	}
 	else if (extension == "ktx")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = std::make_unique<Ktx>(name, data.data(), data.size(), content_type);
 	}
 	else if (extension == "ktx2")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = std::make_unique<Ktx>(name, data.data(), data.size(), content_type);
 	}
 
 	return image;
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <typeinfo>
@@ -38,6 +39,36 @@ namespace sg
  */
 bool is_astc(VkFormat format);
 
+/**
+ * @brief Processes the rows of an image in parallel, on a pool of threads shared by all the images
+ *        On the threads marked by an ImageWorkerScope, the rows are processed inline instead
+ * @param row_count Number of rows
+ * @param min_rows_per_thread Minimum number of rows worth processing on a thread of their own
+ * @param process_rows Processes the rows in [first_row, last_row), it is called from several threads at once
+ */
+void process_rows_in_parallel(uint32_t row_count, uint32_t min_rows_per_thread, const std::function<void(uint32_t, uint32_t)> &process_rows);
+
+/**
+ * @brief Marks the current thread as one of several threads processing images at once, for the lifetime of the scope
+ *
+ * The workers of the loader already keep every core busy with an image each, spreading the rows of their images
+ * over more threads would only oversubscribe the CPU.
+ */
+class ImageWorkerScope
+{
+  public:
+	ImageWorkerScope();
+
+	~ImageWorkerScope();
+
+	ImageWorkerScope(const ImageWorkerScope &) = delete;
+
+	ImageWorkerScope &operator=(const ImageWorkerScope &) = delete;
+
+  private:
+	bool previous;
+};
+
 /**
  * @brief Mipmap information
  */
@@ -17,9 +17,11 @@
 
 #include "scene_graph/components/image/astc.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "common/error.h"
+#include "common/helpers.h"
 
 VKBP_DISABLE_WARNINGS()
 #include "common/glm_common.h"
@@ -32,6 +34,9 @@ VKBP_ENABLE_WARNINGS()
 
 #define MAGIC_FILE_CONSTANT 0x5CA1AB13
 
+// Minimum number of rows of blocks decoded by a worker thread, so that small images are not split
+#define MIN_BLOCK_ROWS_PER_THREAD 16
+
 namespace vkb
 {
 namespace sg
@@ -147,11 +152,14 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data_)
 	auto astc_image = allocate_image(bitness, xsize, ysize, zsize, 0);
 	initialize_image(astc_image);
 
-	imageblock pb;
-	for (int z = 0; z < zblocks; z++)
-	{
-		for (int y = 0; y < yblocks; y++)
+	// Decodes a range of rows of blocks, the rows are indexed across all the slices
+	auto decode_rows = [&](int first_row, int last_row) {
+		imageblock pb;
+		for (int row = first_row; row < last_row; row++)
 		{
+			int z = row / yblocks;
+			int y = row % yblocks;
+
 			for (int x = 0; x < xblocks; x++)
 			{
 				int            offset = (((z * yblocks + y) * xblocks) + x) * 16;
@@ -165,46 +173,71 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data_)
 				write_imageblock(astc_image, &pb, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim, swz_decode);
 			}
 		}
-	}
+	};
 
-	set_data(astc_image->imagedata8[0][0], astc_image->xsize * astc_image->ysize * astc_image->zsize * 4);
-	set_format(VK_FORMAT_R8G8B8A8_SRGB);
-	set_width(static_cast<uint32_t>(astc_image->xsize));
-	set_height(static_cast<uint32_t>(astc_image->ysize));
-	set_depth(static_cast<uint32_t>(astc_image->zsize));
+	// Blocks write disjoint texels, so rows can be decoded in parallel once the tables are initialized
+	int row_count = zblocks * yblocks;
+
+	process_rows_in_parallel(static_cast<uint32_t>(row_count), MIN_BLOCK_ROWS_PER_THREAD, [&decode_rows](uint32_t first_row, uint32_t last_row) {
+		decode_rows(static_cast<int>(first_row), static_cast<int>(last_row));
+	});
+
+	auto &image_data = get_mut_data();
+	image_data.insert(image_data.end(), astc_image->imagedata8[0][0], astc_image->imagedata8[0][0] + xsize * ysize * zsize * 4);
 
 	destroy_image(astc_image);
 }
 
-Astc::Astc(const Image &image) :
+Astc::Astc(const Image &image, bool decode_mipmaps) :
     Image{image.get_name()}
 {
 	init();
 
-	// Locate mip #0 in the KTX. This is the first one in the data array for KTX1s, but the last one in KTX2s!
-	auto mip_it = std::find_if(image.get_mipmaps().begin(), image.get_mipmaps().end(),
-	                           [](auto &mip) { return mip.level == 0; });
-	assert(mip_it != image.get_mipmaps().end() && "Mip #0 not found");
+	// Sort the mips by level, as mip #0 is the first one in the data array for KTX1s, but the last one in KTX2s!
+	std::vector<Mipmap> source_mipmaps = image.get_mipmaps();
+	std::sort(source_mipmaps.begin(), source_mipmaps.end(),
+	          [](const Mipmap &lhs, const Mipmap &rhs) { return lhs.level < rhs.level; });
+	assert(!source_mipmaps.empty() && source_mipmaps[0].level == 0 && "Mip #0 not found");
+
+	// By default, we just decode mip #0 and re-generate the other LODs later (via image->generate_mipmaps()).
+	// Decoding the mips of the file instead keeps their authored content and avoids resampling on the CPU.
+	if (!decode_mipmaps)
+	{
+		source_mipmaps.resize(1);
+	}
+
+	const auto blockdim = to_blockdim(image.get_format());
+
+	auto &mipmaps = get_mut_mipmaps();
+	mipmaps.clear();
+
+	for (auto &source_mipmap : source_mipmaps)
+	{
+		Mipmap mipmap{};
+		mipmap.level  = source_mipmap.level;
+		mipmap.offset = to_u32(get_data().size());
+		mipmap.extent = source_mipmap.extent;
+
+		decode(blockdim, source_mipmap.extent, image.get_data().data() + source_mipmap.offset);
 
-	// When decoding ASTC on CPU (as it is the case in here), we don't decode all mips in the mip chain.
-	// Instead, we just decode mip #0 and re-generate the other LODs later (via image->generate_mipmaps()).
-	const auto     blockdim = to_blockdim(image.get_format());
-	const uint8_t *data_ptr = image.get_data().data() + mip_it->offset;
-	decode(blockdim, mip_it->extent, data_ptr);
+		mipmaps.push_back(mipmap);
+	}
+
+	set_format(VK_FORMAT_R8G8B8A8_SRGB);
 }
 
-Astc::Astc(const std::string &name, const std::vector<uint8_t> &data) :
+Astc::Astc(const std::string &name, const uint8_t *data, size_t size) :
     Image{name}
 {
 	init();
 
 	// Read header
-	if (data.size() < sizeof(AstcHeader))
+	if (size < sizeof(AstcHeader))
 	{
 		throw std::runtime_error{"Error reading astc: invalid memory"};
 	}
 	AstcHeader header{};
-	std::memcpy(&header, data.data(), sizeof(AstcHeader));
+	std::memcpy(&header, data, sizeof(AstcHeader));
 	uint32_t magicval = header.magic[0] + 256 * static_cast<uint32_t>(header.magic[1]) + 65536 * static_cast<uint32_t>(header.magic[2]) + 16777216 * static_cast<uint32_t>(header.magic[3]);
 	if (magicval != MAGIC_FILE_CONSTANT)
 	{
@@ -221,7 +254,12 @@ Astc::Astc(const std::string &name, const std::vector<uint8_t> &data) :
 	    /* height = */ static_cast<uint32_t>(header.ysize[0] + 256 * header.ysize[1] + 65536 * header.ysize[2]),
 	    /* depth  = */ static_cast<uint32_t>(header.zsize[0] + 256 * header.zsize[1] + 65536 * header.zsize[2])};
 
-	decode(blockdim, extent, data.data() + sizeof(AstcHeader));
+	decode(blockdim, extent, data + sizeof(AstcHeader));
+
+	set_format(VK_FORMAT_R8G8B8A8_SRGB);
+	set_width(extent.width);
+	set_height(extent.height);
+	set_depth(extent.depth);
 }
 
 }        // namespace sg
@@ -37,21 +37,25 @@ class Astc : public Image
 	/**
 	 * @brief Decodes an ASTC image
 	 * @param image Image to decode
+	 * @param decode_mipmaps If true, all the mipmaps of the image are decoded, otherwise only mip #0 is,
+	 *                       and the caller is expected to generate the others
 	 */
-	Astc(const Image &image);
+	Astc(const Image &image, bool decode_mipmaps = false);
 
 	/**
 	 * @brief Decodes ASTC data with an ASTC header
 	 * @param name Name of the component
 	 * @param data ASTC data with header
+	 * @param size Size of the data
 	 */
-	Astc(const std::string &name, const std::vector<uint8_t> &data);
+	Astc(const std::string &name, const uint8_t *data, size_t size);
 
 	virtual ~Astc() = default;
 
   private:
 	/**
-	 * @brief Decodes ASTC data
+	 * @brief Decodes ASTC data and appends the RGBA8 texels to the data of the image
+	 *        Rows of blocks are distributed across worker threads
 	 * @param blockdim Dimensions of the block
 	 * @param extent Extent of the image
 	 * @param data Pointer to ASTC image data
@@ -54,6 +54,36 @@ bool SubMesh::get_attribute(const std::string &attribute_name, VertexAttribute &
 	return true;
 }
 
+bool SubMesh::get_vertex_buffer(const std::string &name, const core::Buffer *&buffer, VkDeviceSize &offset) const
+{
+	auto buffer_it = vertex_buffers.find(name);
+
+	if (buffer_it != vertex_buffers.end())
+	{
+		buffer = &buffer_it->second;
+		offset = 0;
+
+		return true;
+	}
+
+	auto packed_buffer_it = packed_vertex_buffers.find(name);
+
+	if (packed_buffer_it != packed_vertex_buffers.end())
+	{
+		buffer = packed_buffer_it->second.buffer.get();
+		offset = packed_buffer_it->second.offset;
+
+		return true;
+	}
+
+	return false;
+}
+
+const core::Buffer *SubMesh::get_index_buffer() const
+{
+	return index_buffer ? index_buffer.get() : packed_index_buffer.get();
+}
+
 void SubMesh::set_material(const Material &new_material)
 {
 	material = &new_material;
@@ -43,6 +43,16 @@ struct VertexAttribute
 	std::uint32_t offset = 0;
 };
 
+/**
+ * @brief A range of a buffer which holds the data of several submeshes
+ */
+struct BufferRange
+{
+	std::shared_ptr<core::Buffer> buffer;
+
+	VkDeviceSize offset = 0;
+};
+
 class SubMesh : public Component
 {
   public:
@@ -64,6 +74,29 @@ class SubMesh : public Component
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
+	/// Vertex buffers shared with other submeshes, used instead of vertex_buffers when the geometry of a scene is packed
+	std::unordered_map<std::string, BufferRange> packed_vertex_buffers;
+
+	/// Index buffer shared with other submeshes, used instead of index_buffer when the geometry of a scene is packed
+	std::shared_ptr<core::Buffer> packed_index_buffer;
+
+	/// First index of the submesh in the packed index buffer
+	std::uint32_t first_index = 0;
+
+	/**
+	 * @brief Finds the buffer holding a vertex attribute, whether the geometry is packed or not
+	 * @param name The name of the attribute
+	 * @param buffer Set to the buffer holding the attribute
+	 * @param offset Set to the offset of the attribute data in the buffer
+	 * @return Whether the submesh has the attribute
+	 */
+	bool get_vertex_buffer(const std::string &name, const core::Buffer *&buffer, VkDeviceSize &offset) const;
+
+	/**
+	 * @return The buffer holding the indices, whether the geometry is packed or not
+	 */
+	const core::Buffer *get_index_buffer() const;
+
 	void set_attribute(const std::string &name, const VertexAttribute &attribute);
 
 	bool get_attribute(const std::string &name, VertexAttribute &attribute) const;
@@ -35,7 +35,8 @@ std::type_index Texture::get_type()
 
 void Texture::set_image(Image &i)
 {
-	image = &i;
+	image      = &i;
+	image_view = nullptr;
 }
 
 Image *Texture::get_image()
@@ -43,6 +44,22 @@ Image *Texture::get_image()
 	return image;
 }
 
+void Texture::set_image_view(const core::ImageView *view)
+{
+	image_view = view;
+}
+
+const core::ImageView &Texture::get_image_view() const
+{
+	if (image_view)
+	{
+		return *image_view;
+	}
+
+	assert(image && "Texture has no image");
+	return image->get_vk_image_view();
+}
+
 void Texture::set_sampler(Sampler &s)
 {
 	sampler = &s;
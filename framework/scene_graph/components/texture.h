@@ -27,6 +27,11 @@
 
 namespace vkb
 {
+namespace core
+{
+class ImageView;
+}        // namespace core
+
 namespace sg
 {
 class Image;
@@ -43,10 +48,27 @@ class Texture : public Component
 
 	virtual std::type_index get_type() override;
 
+	/**
+	 * @brief Sets the image of the texture, which also drops any view that overrides the view of the previous image
+	 */
 	void set_image(Image &image);
 
+	/**
+	 * @return The image of the texture, use get_image_view() to sample it as its Vulkan image may not be resident yet
+	 */
 	Image *get_image();
 
+	/**
+	 * @brief Overrides the view sampled by the texture, for instance while its image is streamed
+	 * @param image_view The view to sample, nullptr to sample the view of the image
+	 */
+	void set_image_view(const core::ImageView *image_view);
+
+	/**
+	 * @return The view sampled by the texture, which is the one every consumer of the texture should bind
+	 */
+	const core::ImageView &get_image_view() const;
+
 	void set_sampler(Sampler &sampler);
 
 	Sampler *get_sampler();
@@ -54,6 +76,8 @@ class Texture : public Component
   private:
 	Image *image{nullptr};
 
+	const core::ImageView *image_view{nullptr};
+
 	Sampler *sampler{nullptr};
 };
 }        // namespace sg
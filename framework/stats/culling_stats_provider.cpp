@@ -0,0 +1,47 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "culling_stats_provider.h"
+
+namespace vkb
+{
+CullingStatsProvider::CullingStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	// Culling counts are always available, remove them from the requested set
+	requested_stats.erase(StatIndex::visible_submeshes);
+	requested_stats.erase(StatIndex::culled_submeshes);
+}
+
+bool CullingStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::visible_submeshes || index == StatIndex::culled_submeshes;
+}
+
+StatsProvider::Counters CullingStatsProvider::sample(float delta_time)
+{
+	Counters res;
+	res[StatIndex::visible_submeshes].result = visible_submeshes.exchange(0);
+	res[StatIndex::culled_submeshes].result  = culled_submeshes.exchange(0);
+	return res;
+}
+
+void CullingStatsProvider::record(uint32_t visible_count, uint32_t culled_count)
+{
+	visible_submeshes += visible_count;
+	culled_submeshes += culled_count;
+}
+}        // namespace vkb
@@ -0,0 +1,66 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+/**
+ * @brief Provides the number of submeshes drawn and skipped by frustum culling
+ *
+ * The counts are reported by the subpasses while recording, and may be reported
+ * from several threads at once. They accumulate until the next sample.
+ */
+class CullingStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a CullingStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 */
+	CullingStatsProvider(std::set<StatIndex> &requested_stats);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+	/**
+	 * @brief Adds the results of a culling pass to the counts of the current sample
+	 * @param visible_count Number of submeshes which passed culling
+	 * @param culled_count Number of submeshes which were culled
+	 */
+	void record(uint32_t visible_count, uint32_t culled_count);
+
+  private:
+	std::atomic<uint32_t> visible_submeshes{0};
+
+	std::atomic<uint32_t> culled_submeshes{0};
+};
+}        // namespace vkb
@@ -0,0 +1,156 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gpu_time_stats_provider.h"
+
+#include <array>
+
+#include "core/command_buffer.h"
+#include "core/device.h"
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+GpuTimeStatsProvider::GpuTimeStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context(render_context)
+{
+	if (requested_stats.find(StatIndex::gpu_time) != requested_stats.end() && enable())
+	{
+		requested_stats.erase(StatIndex::gpu_time);
+	}
+}
+
+bool GpuTimeStatsProvider::enable()
+{
+	if (timestamp_pool)
+	{
+		return true;
+	}
+
+	Device &device = render_context.get_device();
+
+	const auto &limits = device.get_gpu().get_properties().limits;
+	if (!limits.timestampComputeAndGraphics)
+	{
+		return false;
+	}
+
+	timestamp_period = limits.timestampPeriod;
+
+	uint32_t num_framebuffers = static_cast<uint32_t>(render_context.get_render_frames().size());
+
+	VkQueryPoolCreateInfo timestamp_pool_create_info{};
+	timestamp_pool_create_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	timestamp_pool_create_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	timestamp_pool_create_info.queryCount = num_framebuffers * 2;        // 2 timestamps per frame (start & end)
+
+	timestamp_pool = std::make_unique<QueryPool>(device, timestamp_pool_create_info);
+
+	query_frames.resize(num_framebuffers, 0);
+
+	return true;
+}
+
+bool GpuTimeStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::gpu_time && timestamp_pool;
+}
+
+void GpuTimeStatsProvider::begin_sampling(CommandBuffer &cb)
+{
+	if (!timestamp_pool)
+	{
+		return;
+	}
+
+	uint32_t active_frame_idx = render_context.get_active_frame_index();
+
+	// The frame these timestamps were written by has completed, drop them if they were not read in time
+	query_frames[active_frame_idx] = 0;
+
+	cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2, 1);
+	cb.write_timestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, *timestamp_pool, active_frame_idx * 2);
+}
+
+void GpuTimeStatsProvider::end_sampling(CommandBuffer &cb)
+{
+	if (!timestamp_pool)
+	{
+		return;
+	}
+
+	uint32_t active_frame_idx = render_context.get_active_frame_index();
+
+	cb.reset_query_pool(*timestamp_pool, active_frame_idx * 2 + 1, 1);
+	cb.write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, *timestamp_pool, active_frame_idx * 2 + 1);
+
+	query_frames[active_frame_idx] = ++frame_number;
+}
+
+StatsProvider::Counters GpuTimeStatsProvider::sample(float delta_time)
+{
+	Counters out;
+	if (!timestamp_pool)
+	{
+		return out;
+	}
+
+	// Read the timestamps of the frames which completed, without waiting for the GPU.
+	// Only the most recent time is reported, the others are dropped.
+	uint64_t sampled_frame = 0;
+	float    gpu_time      = 0.0f;
+
+	for (uint32_t frame_index = 0; frame_index < query_frames.size(); frame_index++)
+	{
+		if (query_frames[frame_index] == 0)
+		{
+			continue;
+		}
+
+		// Each timestamp is followed by its availability
+		std::array<uint64_t, 4> timestamps;
+
+		VkResult r = timestamp_pool->get_results(frame_index * 2, 2,
+		                                         timestamps.size() * sizeof(uint64_t),
+		                                         timestamps.data(), 2 * sizeof(uint64_t),
+		                                         VK_QUERY_RESULT_WITH_AVAILABILITY_BIT | VK_QUERY_RESULT_64_BIT);
+		if (r != VK_SUCCESS || timestamps[1] == 0 || timestamps[3] == 0)
+		{
+			continue;
+		}
+
+		if (query_frames[frame_index] > sampled_frame)
+		{
+			sampled_frame = query_frames[frame_index];
+			gpu_time      = timestamp_period * static_cast<float>(timestamps[2] - timestamps[0]) * 0.000000001f;
+		}
+
+		query_frames[frame_index] = 0;
+	}
+
+	if (sampled_frame == 0)
+	{
+		return out;
+	}
+
+	// The frame being recorded is the one after the last that ended sampling
+	out[StatIndex::gpu_time].result      = gpu_time;
+	out[StatIndex::gpu_time].frame_delay = static_cast<uint32_t>(frame_number + 1 - sampled_frame);
+
+	return out;
+}
+}        // namespace vkb
@@ -0,0 +1,90 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "core/query_pool.h"
+#include "stats_provider.h"
+
+namespace vkb
+{
+class RenderContext;
+
+/**
+ * @brief Provides the time the GPU spends executing the sampled command buffer of each frame
+ *
+ * The time is measured with a pair of timestamp queries, so unlike the VulkanStatsProvider it does not need
+ * VK_KHR_performance_query nor vendor counters, only timestamp support on the graphics and compute queues.
+ * The timestamps are read back without waiting for the GPU, a few frames late.
+ */
+class GpuTimeStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a GpuTimeStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 * @param render_context The render context
+	 */
+	GpuTimeStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context);
+
+	/**
+	 * @brief Starts measuring the GPU time, for when it is needed after the stats were requested
+	 * @return True if the GPU time is available, false if timestamps are not supported
+	 */
+	bool enable();
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+	/**
+	 * @brief A command buffer that we want stats about has just begun
+	 * @param cb The command buffer
+	 */
+	void begin_sampling(CommandBuffer &cb) override;
+
+	/**
+	 * @brief A command buffer that we want stats about is about to be ended
+	 * @param cb The command buffer
+	 */
+	void end_sampling(CommandBuffer &cb) override;
+
+  private:
+	RenderContext &render_context;
+
+	// The timestamp period
+	float timestamp_period{1.0f};
+
+	// Two timestamps per render frame, at the start and at the end of its command buffer
+	std::unique_ptr<QueryPool> timestamp_pool;
+
+	// The number of frames which ended sampling
+	uint64_t frame_number{0};
+
+	// For each render frame, the number of the frame whose timestamps were not read yet, or 0
+	std::vector<uint64_t> query_frames;
+};
+}        // namespace vkb
@@ -19,6 +19,7 @@
 
 #include <stats/stats.h>
 
+#include <hpp_ring_buffer.h>
 #include <rendering/hpp_render_context.h>
 
 namespace vkb
@@ -37,6 +38,8 @@ class HPPStats : private vkb::Stats
 	using vkb::Stats::get_graph_data;
 	using vkb::Stats::get_requested_stats;
 	using vkb::Stats::is_available;
+	using vkb::Stats::record_culling;
+	using vkb::Stats::request_gpu_time;
 	using vkb::Stats::request_stats;
 	using vkb::Stats::resize;
 	using vkb::Stats::update;
@@ -54,6 +57,11 @@ class HPPStats : private vkb::Stats
 	{
 		vkb::Stats::end_sampling(reinterpret_cast<vkb::CommandBuffer &>(cb));
 	}
+
+	void track_ring_buffer(const vkb::HPPRingBuffer &ring_buffer)
+	{
+		vkb::Stats::track_ring_buffer(reinterpret_cast<const vkb::RingBuffer &>(ring_buffer));
+	}
 };
 
 }        // namespace stats
@@ -0,0 +1,321 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "perf_event_stats_provider.h"
+
+#include "common/logging.h"
+
+#if defined(__linux__)
+#	include <cerrno>
+#	include <cstdlib>
+#	include <dirent.h>
+#	include <linux/perf_event.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace vkb
+{
+namespace
+{
+const size_t NO_EVENT = ~static_cast<size_t>(0);
+
+#if defined(__linux__)
+inline int open_event(uint32_t type, uint64_t config, int thread)
+{
+	perf_event_attr attr{};
+	attr.size   = sizeof(attr);
+	attr.type   = type;
+	attr.config = config;
+
+	// Kernel events need a lower perf_event_paranoid than user space ones
+	attr.exclude_kernel = 1;
+	attr.exclude_hv     = 1;
+	attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return static_cast<int>(syscall(__NR_perf_event_open, &attr, thread, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+inline std::vector<int> list_threads()
+{
+	std::vector<int> threads;
+
+	DIR *dir = opendir("/proc/self/task");
+	if (!dir)
+	{
+		return threads;
+	}
+
+	while (auto *entry = readdir(dir))
+	{
+		if (entry->d_name[0] != '.')
+		{
+			threads.push_back(std::atoi(entry->d_name));
+		}
+	}
+
+	closedir(dir);
+
+	return threads;
+}
+
+inline uint64_t hw_cache_config(uint64_t cache, uint64_t op, uint64_t result)
+{
+	return cache | (op << 8) | (result << 16);
+}
+#endif
+}        // namespace
+
+PerfEventStatsProvider::PerfEventStatsProvider(std::set<StatIndex> &requested_stats)
+{
+#if defined(__linux__)
+	struct StatEvents
+	{
+		Event       event;
+		StatScaling scaling;
+		Event       divisor;
+	};
+
+	const Event none{PERF_TYPE_MAX, 0};
+
+	// Mapping of stats to the generic events the kernel translates for each PMU
+	// clang-format off
+	std::unordered_map<StatIndex, StatEvents, StatIndexHash> perf_stats = {
+	    {StatIndex::cpu_cycles,            {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},    StatScaling::ByDeltaTime, none}},
+	    {StatIndex::cpu_instructions,      {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},  StatScaling::ByDeltaTime, none}},
+	    {StatIndex::cpu_cache_miss_ratio,  {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},  StatScaling::ByCounter,   {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES}}},
+	    {StatIndex::cpu_branch_miss_ratio, {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}, StatScaling::ByCounter,   {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS}}},
+	    {StatIndex::cpu_l1_accesses,       {{PERF_TYPE_HW_CACHE, hw_cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS)}, StatScaling::ByDeltaTime, none}},
+	    {StatIndex::cpu_l3_accesses,       {{PERF_TYPE_HW_CACHE, hw_cache_config(PERF_COUNT_HW_CACHE_LL,  PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_ACCESS)}, StatScaling::ByDeltaTime, none}}};
+	// clang-format on
+
+	int  main_thread   = static_cast<int>(syscall(SYS_gettid));
+	bool access_denied = false;
+
+	// Adds an event once, if the kernel can count it on this thread
+	auto add_event = [&](const Event &event) {
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			if (events[i].type == event.type && events[i].config == event.config)
+			{
+				return i;
+			}
+		}
+
+		int fd = open_event(event.type, event.config, main_thread);
+		if (fd < 0)
+		{
+			access_denied |= errno == EACCES || errno == EPERM;
+			return NO_EVENT;
+		}
+		close(fd);
+
+		events.push_back(event);
+		return events.size() - 1;
+	};
+
+	for (const auto &stat : requested_stats)
+	{
+		auto res = perf_stats.find(stat);
+		if (res == perf_stats.end())
+		{
+			continue;
+		}
+
+		StatData data{res->second.scaling, add_event(res->second.event), NO_EVENT};
+		if (data.scaling == StatScaling::ByCounter)
+		{
+			data.divisor_event = add_event(res->second.divisor);
+		}
+
+		if (data.event != NO_EVENT && (data.scaling != StatScaling::ByCounter || data.divisor_event != NO_EVENT))
+		{
+			stat_data[stat] = data;
+		}
+	}
+
+	if (access_denied)
+	{
+		LOGW("PerfEventStatsProvider: access to perf events was denied, check /proc/sys/kernel/perf_event_paranoid");
+	}
+
+	// Remove any supported stats from the requested set.
+	// Subsequent providers will then only look for things that aren't already supported.
+	for (const auto &iter : stat_data)
+	{
+		requested_stats.erase(iter.first);
+	}
+
+	if (!stat_data.empty())
+	{
+		update_threads();
+	}
+#endif
+}
+
+PerfEventStatsProvider::~PerfEventStatsProvider()
+{
+#if defined(__linux__)
+	for (auto &thread : threads)
+	{
+		for (auto &counter : thread.second.counters)
+		{
+			if (counter.fd >= 0)
+			{
+				close(counter.fd);
+			}
+		}
+	}
+#endif
+}
+
+bool PerfEventStatsProvider::is_available(StatIndex index) const
+{
+	return stat_data.find(index) != stat_data.end();
+}
+
+void PerfEventStatsProvider::update_threads()
+{
+#if defined(__linux__)
+	for (auto &thread : threads)
+	{
+		thread.second.alive = false;
+	}
+
+	for (auto id : list_threads())
+	{
+		auto it = threads.find(id);
+		if (it != threads.end())
+		{
+			it->second.alive = true;
+			continue;
+		}
+
+		// The thread is new, its events start counting from zero
+		ThreadCounters thread;
+		thread.counters.resize(events.size());
+
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			thread.counters[i].fd = open_event(events[i].type, events[i].config, id);
+		}
+
+		threads.emplace(id, std::move(thread));
+	}
+#endif
+}
+
+void PerfEventStatsProvider::read_thread(ThreadCounters &thread, std::vector<double> &deltas)
+{
+#if defined(__linux__)
+	for (size_t i = 0; i < thread.counters.size(); i++)
+	{
+		auto &counter = thread.counters[i];
+		if (counter.fd < 0)
+		{
+			continue;
+		}
+
+		// The value, followed by the time the event was enabled and the time it was counted
+		uint64_t values[3];
+		if (read(counter.fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)))
+		{
+			continue;
+		}
+
+		double delta         = static_cast<double>(values[0] - counter.value);
+		auto   enabled_delta = values[1] - counter.time_enabled;
+		auto   running_delta = values[2] - counter.time_running;
+
+		// The event was multiplexed with others, extrapolate its count for the time it was not counted
+		if (running_delta > 0 && running_delta < enabled_delta)
+		{
+			delta *= static_cast<double>(enabled_delta) / static_cast<double>(running_delta);
+		}
+
+		deltas[i] += delta;
+
+		counter.value        = values[0];
+		counter.time_enabled = values[1];
+		counter.time_running = values[2];
+	}
+#endif
+}
+
+StatsProvider::Counters PerfEventStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	if (stat_data.empty())
+	{
+		return res;
+	}
+
+	update_threads();
+
+	std::vector<double> deltas(events.size(), 0.0);
+
+	for (auto it = threads.begin(); it != threads.end();)
+	{
+		read_thread(it->second, deltas);
+
+		if (it->second.alive)
+		{
+			++it;
+			continue;
+		}
+
+		// The thread exited, what it counted since the last sample was read above
+#if defined(__linux__)
+		for (auto &counter : it->second.counters)
+		{
+			if (counter.fd >= 0)
+			{
+				close(counter.fd);
+			}
+		}
+#endif
+		it = threads.erase(it);
+	}
+
+	for (const auto &iter : stat_data)
+	{
+		const StatData &data = iter.second;
+
+		double d = deltas[data.event];
+
+		if (data.scaling == StatScaling::ByDeltaTime && delta_time != 0.0f)
+		{
+			d /= delta_time;
+		}
+		else if (data.scaling == StatScaling::ByCounter)
+		{
+			double divisor = deltas[data.divisor_event];
+			d              = divisor != 0.0 ? d / divisor : 0.0;
+		}
+
+		res[iter.first].result = d;
+	}
+
+	return res;
+}
+
+StatsProvider::Counters PerfEventStatsProvider::continuous_sample(float delta_time)
+{
+	return sample(delta_time);
+}
+}        // namespace vkb
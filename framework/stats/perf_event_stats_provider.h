@@ -0,0 +1,138 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+/**
+ * @brief Provides the CPU stats with the generic hardware events of the Linux perf_event interface,
+ *        so that they are available on any CPU the kernel has a PMU driver for
+ *
+ * The events are counted per thread, in user space only, for every thread of the process: the main thread
+ * and the worker threads, which are found as they are created. The counts of all threads are summed when sampled.
+ * Events which are multiplexed by the kernel, when there are more of them than hardware counters,
+ * are scaled by the fraction of time they were counted.
+ *
+ * On other platforms, or when the kernel denies access to the events, no stat is available.
+ */
+class PerfEventStatsProvider : public StatsProvider
+{
+  private:
+	/**
+	 * @brief A perf event, as the type and config of its perf_event_attr
+	 */
+	struct Event
+	{
+		uint32_t type;
+		uint64_t config;
+	};
+
+	struct StatData
+	{
+		StatScaling scaling;
+
+		/// Index of the event counted in events
+		size_t event;
+
+		/// Index of the event used as divisor if scaling is ByCounter
+		size_t divisor_event;
+	};
+
+	/**
+	 * @brief An event counted for one thread
+	 */
+	struct EventCounter
+	{
+		int fd{-1};
+
+		uint64_t value{0};
+
+		uint64_t time_enabled{0};
+
+		uint64_t time_running{0};
+	};
+
+	/**
+	 * @brief The events counted for one thread, in the order of events
+	 */
+	struct ThreadCounters
+	{
+		std::vector<EventCounter> counters;
+
+		bool alive{true};
+	};
+
+	using StatDataMap = std::unordered_map<StatIndex, StatData, StatIndexHash>;
+
+  public:
+	/**
+	 * @brief Constructs a PerfEventStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 */
+	PerfEventStatsProvider(std::set<StatIndex> &requested_stats);
+
+	~PerfEventStatsProvider();
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set from polled sampling
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+	/**
+	 * @brief Retrieve a new sample set from continuous sampling
+	 * @param delta_time Time since last sample
+	 */
+	Counters continuous_sample(float delta_time) override;
+
+  private:
+	/**
+	 * @brief Starts counting the events on the threads created since the last call,
+	 *        and marks the threads which exited so that their counters are closed once read
+	 */
+	void update_threads();
+
+	/**
+	 * @brief Reads the events of a thread, and adds what they counted since they were last read
+	 * @param thread The counters of the thread
+	 * @param deltas The counts of each event, accumulated for all threads
+	 */
+	void read_thread(ThreadCounters &thread, std::vector<double> &deltas);
+
+	// The events counted, shared by the stats
+	std::vector<Event> events;
+
+	// Only stats which are available and were requested end up in stat_data
+	StatDataMap stat_data;
+
+	// The counters of each thread, by thread id
+	std::map<int, ThreadCounters> threads;
+};
+}        // namespace vkb
@@ -0,0 +1,320 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats/profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+#include "common/logging.h"
+#include "core/command_buffer.h"
+#include "core/command_pool.h"
+#include "core/device.h"
+#include "platform/filesystem.h"
+#include "rendering/render_frame.h"
+
+namespace vkb
+{
+namespace
+{
+const uint32_t INVALID_SCOPE = ~0u;
+}        // namespace
+
+Profiler::Profiler(Device &device, uint32_t max_gpu_scopes, size_t max_captured_frames) :
+    device{device},
+    max_gpu_scopes{max_gpu_scopes},
+    max_captured_frames{max_captured_frames}
+{
+	auto &limits     = device.get_gpu().get_properties().limits;
+	has_timestamps   = limits.timestampComputeAndGraphics == VK_TRUE;
+	timestamp_period = limits.timestampPeriod;
+
+	timer.start();
+}
+
+void Profiler::set_enabled(bool enabled)
+{
+	this->enabled = enabled;
+}
+
+bool Profiler::is_enabled() const
+{
+	return enabled;
+}
+
+void Profiler::begin_frame(const RenderFrame &render_frame)
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	auto &state = frame_states[&render_frame];
+	auto &frame = state.frame;
+
+	if (!frame.scopes.empty())
+	{
+		// The frame completed, its timestamps are available
+		std::vector<uint64_t> timestamps;
+
+		if (state.query_count > 0)
+		{
+			// Each timestamp is followed by its availability
+			timestamps.resize(state.query_count * 2, 0);
+
+			VkResult result = state.query_pool->get_results(0, state.query_count,
+			                                                timestamps.size() * sizeof(uint64_t), timestamps.data(), 2 * sizeof(uint64_t),
+			                                                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+			// Scopes which were not ended in the frame leave their end query unavailable
+			if (result != VK_SUCCESS && result != VK_NOT_READY)
+			{
+				timestamps.clear();
+			}
+		}
+
+		auto is_available = [&timestamps](uint32_t query) {
+			return query != INVALID_SCOPE && timestamps.size() > query * 2 + 3 && timestamps[query * 2 + 1] != 0 && timestamps[query * 2 + 3] != 0;
+		};
+
+		uint64_t first_timestamp = std::numeric_limits<uint64_t>::max();
+		for (auto query : state.scope_queries)
+		{
+			if (is_available(query))
+			{
+				first_timestamp = std::min(first_timestamp, timestamps[query * 2]);
+			}
+		}
+
+		for (size_t i = 0; i < frame.scopes.size(); i++)
+		{
+			auto &scope = frame.scopes[i];
+			auto  query = state.scope_queries[i];
+
+			if (is_available(query))
+			{
+				scope.gpu_begin = (timestamps[query * 2] - first_timestamp) * timestamp_period * 1e-6;
+				scope.gpu_end   = (timestamps[query * 2 + 2] - first_timestamp) * timestamp_period * 1e-6;
+			}
+		}
+
+		captured_frames.push_back(std::move(frame));
+		if (captured_frames.size() > max_captured_frames)
+		{
+			captured_frames.pop_front();
+		}
+	}
+
+	frame           = Frame{};
+	frame.number    = ++frame_count;
+	frame.cpu_begin = get_cpu_time();
+
+	state.scope_queries.clear();
+	state.open_scopes.clear();
+	state.query_count   = 0;
+	state.queries_reset = false;
+
+	if (enabled && has_timestamps && !state.query_pool)
+	{
+		VkQueryPoolCreateInfo query_pool_info{};
+		query_pool_info.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+		query_pool_info.queryCount = max_gpu_scopes * 2;
+
+		state.query_pool = std::make_unique<QueryPool>(device, query_pool_info);
+	}
+}
+
+void Profiler::reset_queries(CommandBuffer &command_buffer)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard{mutex};
+
+	auto *state = find_frame_state(command_buffer);
+	if (state && state->query_pool && !state->queries_reset)
+	{
+		command_buffer.reset_query_pool(*state->query_pool, 0, max_gpu_scopes * 2);
+		state->queries_reset = true;
+	}
+}
+
+uint32_t Profiler::begin_scope(const CommandBuffer &command_buffer, const char *name)
+{
+	if (!enabled)
+	{
+		return INVALID_SCOPE;
+	}
+
+	auto cpu_time = get_cpu_time();
+
+	std::lock_guard<std::mutex> guard{mutex};
+
+	auto *state = find_frame_state(command_buffer);
+	if (!state)
+	{
+		return INVALID_SCOPE;
+	}
+
+	auto &frame       = state->frame;
+	auto &open_scopes = state->open_scopes[command_buffer.get_handle()];
+
+	Scope scope{};
+	scope.name      = name;
+	scope.parent    = open_scopes.empty() ? INVALID_SCOPE : open_scopes.back();
+	scope.depth     = to_u32(open_scopes.size());
+	scope.thread    = get_thread_index();
+	scope.cpu_begin = cpu_time - frame.cpu_begin;
+	scope.cpu_end   = scope.cpu_begin;
+	scope.gpu_begin = -1.0;
+	scope.gpu_end   = -1.0;
+
+	uint32_t query = INVALID_SCOPE;
+	if (state->queries_reset && state->query_count + 2 <= max_gpu_scopes * 2)
+	{
+		query = state->query_count;
+		state->query_count += 2;
+
+		vkCmdWriteTimestamp(command_buffer.get_handle(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, state->query_pool->get_handle(), query);
+	}
+
+	auto index = to_u32(frame.scopes.size());
+
+	frame.scopes.push_back(std::move(scope));
+	state->scope_queries.push_back(query);
+	open_scopes.push_back(index);
+
+	return index;
+}
+
+void Profiler::end_scope(const CommandBuffer &command_buffer, uint32_t scope)
+{
+	if (scope == INVALID_SCOPE)
+	{
+		return;
+	}
+
+	auto cpu_time = get_cpu_time();
+
+	std::lock_guard<std::mutex> guard{mutex};
+
+	auto *state = find_frame_state(command_buffer);
+	if (!state || scope >= state->frame.scopes.size())
+	{
+		return;
+	}
+
+	auto &open_scopes = state->open_scopes[command_buffer.get_handle()];
+	assert(!open_scopes.empty() && open_scopes.back() == scope && "Profiler scopes must be ended in the reverse order they began");
+	open_scopes.pop_back();
+
+	state->frame.scopes[scope].cpu_end = cpu_time - state->frame.cpu_begin;
+
+	auto query = state->scope_queries[scope];
+	if (query != INVALID_SCOPE)
+	{
+		vkCmdWriteTimestamp(command_buffer.get_handle(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, state->query_pool->get_handle(), query + 1);
+	}
+}
+
+Profiler::Frame Profiler::get_last_frame() const
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	return captured_frames.empty() ? Frame{} : captured_frames.back();
+}
+
+bool Profiler::write_chrome_trace(const std::string &filename) const
+{
+	nlohmann::json events = nlohmann::json::array();
+
+	{
+		std::lock_guard<std::mutex> guard{mutex};
+
+		for (auto &frame : captured_frames)
+		{
+			for (auto &scope : frame.scopes)
+			{
+				// Complete events, in microseconds. The CPU records the scopes as process 0, one track per thread
+				events.push_back({{"name", scope.name},
+				                  {"cat", "cpu"},
+				                  {"ph", "X"},
+				                  {"pid", 0},
+				                  {"tid", scope.thread},
+				                  {"ts", (frame.cpu_begin + scope.cpu_begin) * 1000.0},
+				                  {"dur", (scope.cpu_end - scope.cpu_begin) * 1000.0},
+				                  {"args", {{"frame", frame.number}}}});
+
+				// The GPU executes them as process 1, aligned to the beginning of the frame on the CPU as the clocks differ
+				if (scope.gpu_begin >= 0.0)
+				{
+					events.push_back({{"name", scope.name},
+					                  {"cat", "gpu"},
+					                  {"ph", "X"},
+					                  {"pid", 1},
+					                  {"tid", 0},
+					                  {"ts", (frame.cpu_begin + scope.gpu_begin) * 1000.0},
+					                  {"dur", (scope.gpu_end - scope.gpu_begin) * 1000.0},
+					                  {"args", {{"frame", frame.number}}}});
+				}
+			}
+		}
+	}
+
+	nlohmann::json trace;
+	trace["traceEvents"]     = events;
+	trace["displayTimeUnit"] = "ms";
+
+	auto path = fs::path::get(fs::path::Logs) + filename;
+
+	std::ofstream file{path, std::ios::out | std::ios::trunc};
+	file << trace.dump();
+
+	if (!file)
+	{
+		LOGE("Failed to write the profiler trace to {}", path);
+		return false;
+	}
+
+	LOGI("Profiler trace written to {}", path);
+	return true;
+}
+
+Profiler::FrameState *Profiler::find_frame_state(const CommandBuffer &command_buffer)
+{
+	auto *render_frame = command_buffer.get_command_pool().get_render_frame();
+	if (!render_frame)
+	{
+		return nullptr;
+	}
+
+	// Frames are registered when they begin, scopes recorded before are not profiled
+	auto it = frame_states.find(render_frame);
+	return it != frame_states.end() ? &it->second : nullptr;
+}
+
+double Profiler::get_cpu_time()
+{
+	return timer.elapsed<Timer::Milliseconds>();
+}
+
+uint32_t Profiler::get_thread_index()
+{
+	auto it = thread_indices.emplace(std::this_thread::get_id(), to_u32(thread_indices.size()));
+	return it.first->second;
+}
+}        // namespace vkb
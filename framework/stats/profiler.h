@@ -0,0 +1,201 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/query_pool.h"
+#include "timer.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class Device;
+class RenderFrame;
+
+/**
+ * @brief A hierarchical profiler of the scopes recorded in command buffers
+ *
+ * Each scope is timed on the CPU, for the time it took to record, and on the GPU with a pair of timestamp queries,
+ * for the time it took to execute. ScopedDebugLabel begins and ends a scope when the frame of its command buffer
+ * has a profiler, so the passes and draws which are labelled for debuggers are profiled too.
+ *
+ * The scopes of a frame are resolved when the frame is reused, once its fences were waited, so the GPU times
+ * are available without stalling. The last resolved frames are kept, and can be exported as a Chrome trace.
+ */
+class Profiler
+{
+  public:
+	/**
+	 * @brief A profiled scope
+	 */
+	struct Scope
+	{
+		std::string name;
+
+		/// Index of the enclosing scope in the frame, or ~0u if the scope is a root of its command buffer
+		uint32_t parent;
+
+		uint32_t depth;
+
+		/// Index of the thread which recorded the scope, in the order threads were first seen
+		uint32_t thread;
+
+		/// CPU times in milliseconds since the frame began
+		double cpu_begin;
+
+		double cpu_end;
+
+		/// GPU times in milliseconds since the first timestamp of the frame, or negative if they were not measured
+		double gpu_begin;
+
+		double gpu_end;
+	};
+
+	/**
+	 * @brief The scopes of a frame, in the order they began
+	 */
+	struct Frame
+	{
+		uint64_t number{0};
+
+		/// CPU time in milliseconds since the profiler was created
+		double cpu_begin{0.0};
+
+		std::vector<Scope> scopes;
+	};
+
+	/**
+	 * @param device The device the profiled command buffers are recorded for
+	 * @param max_gpu_scopes The number of scopes of a frame which are timed on the GPU, the others are only timed on the CPU
+	 * @param max_captured_frames The number of resolved frames kept for the Chrome trace
+	 */
+	Profiler(Device &device, uint32_t max_gpu_scopes = 512, size_t max_captured_frames = 300);
+
+	Profiler(const Profiler &) = delete;
+
+	Profiler(Profiler &&) = delete;
+
+	Profiler &operator=(const Profiler &) = delete;
+
+	Profiler &operator=(Profiler &&) = delete;
+
+	void set_enabled(bool enabled);
+
+	bool is_enabled() const;
+
+	/**
+	 * @brief Resolves the scopes last recorded for a frame, and starts recording new ones
+	 *        It must be called once the fences of the frame were waited, RenderFrame::reset does it
+	 * @param frame The frame starting
+	 */
+	void begin_frame(const RenderFrame &frame);
+
+	/**
+	 * @brief Resets the timestamp queries of the frame of a command buffer
+	 *        It must be recorded outside a render pass, before the first scope of the frame is submitted.
+	 *        The scopes of a frame whose queries were not reset are only timed on the CPU.
+	 * @param command_buffer A command buffer allocated from a render frame
+	 */
+	void reset_queries(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Begins a scope, it can be called from multiple threads
+	 * @param command_buffer A command buffer allocated from a render frame
+	 * @param name The name of the scope
+	 * @return The scope to end, or ~0u if it is not profiled
+	 */
+	uint32_t begin_scope(const CommandBuffer &command_buffer, const char *name);
+
+	/**
+	 * @brief Ends a scope, it can be called from multiple threads
+	 * @param command_buffer The command buffer the scope began in
+	 * @param scope The scope returned by begin_scope
+	 */
+	void end_scope(const CommandBuffer &command_buffer, uint32_t scope);
+
+	/**
+	 * @return The last frame which was resolved
+	 */
+	Frame get_last_frame() const;
+
+	/**
+	 * @brief Writes the captured frames as a Chrome trace, which chrome://tracing and Perfetto can open
+	 * @param filename The name of the file in the logs directory
+	 * @return True if the file was written
+	 */
+	bool write_chrome_trace(const std::string &filename) const;
+
+  private:
+	struct FrameState
+	{
+		/// Timestamp queries of the frame, two per scope
+		std::unique_ptr<QueryPool> query_pool;
+
+		bool queries_reset{false};
+
+		uint32_t query_count{0};
+
+		Frame frame;
+
+		/// The first timestamp query of each scope, or ~0u
+		std::vector<uint32_t> scope_queries;
+
+		/// The scopes each command buffer is in
+		std::unordered_map<VkCommandBuffer, std::vector<uint32_t>> open_scopes;
+	};
+
+	FrameState *find_frame_state(const CommandBuffer &command_buffer);
+
+	double get_cpu_time();
+
+	uint32_t get_thread_index();
+
+	Device &device;
+
+	uint32_t max_gpu_scopes;
+
+	size_t max_captured_frames;
+
+	bool has_timestamps{false};
+
+	float timestamp_period{1.0f};
+
+	std::atomic<bool> enabled{false};
+
+	Timer timer;
+
+	uint64_t frame_count{0};
+
+	std::unordered_map<const RenderFrame *, FrameState> frame_states;
+
+	std::unordered_map<std::thread::id, uint32_t> thread_indices;
+
+	std::deque<Frame> captured_frames;
+
+	mutable std::mutex mutex;
+};
+}        // namespace vkb
@@ -0,0 +1,57 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ring_buffer_stats_provider.h"
+
+#include "ring_buffer.h"
+
+namespace vkb
+{
+RingBufferStatsProvider::RingBufferStatsProvider(std::set<StatIndex> &requested_stats)
+{
+	// The high-water mark is always available, remove it from the requested set
+	requested_stats.erase(StatIndex::ring_buffer_peak);
+}
+
+bool RingBufferStatsProvider::is_available(StatIndex index) const
+{
+	return index == StatIndex::ring_buffer_peak;
+}
+
+StatsProvider::Counters RingBufferStatsProvider::sample(float delta_time)
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	VkDeviceSize high_water_mark = 0;
+	for (auto ring_buffer : ring_buffers)
+	{
+		high_water_mark += ring_buffer->get_high_water_mark();
+	}
+
+	Counters res;
+	res[StatIndex::ring_buffer_peak].result = static_cast<double>(high_water_mark);
+	return res;
+}
+
+void RingBufferStatsProvider::track(const RingBuffer &ring_buffer)
+{
+	std::lock_guard<std::mutex> guard{mutex};
+
+	ring_buffers.push_back(&ring_buffer);
+}
+}        // namespace vkb
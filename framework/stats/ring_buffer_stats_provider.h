@@ -0,0 +1,68 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "stats_provider.h"
+
+namespace vkb
+{
+class RingBuffer;
+
+/**
+ * @brief Provides the high-water mark of the ring buffers which per-frame data is streamed through
+ *
+ * The ring buffers are tracked explicitly, as they are owned by the samples and shared by all the frames.
+ */
+class RingBufferStatsProvider : public StatsProvider
+{
+  public:
+	/**
+	 * @brief Constructs a RingBufferStatsProvider
+	 * @param requested_stats Set of stats to be collected. Supported stats will be removed from the set.
+	 */
+	RingBufferStatsProvider(std::set<StatIndex> &requested_stats);
+
+	/**
+	 * @brief Checks if this provider can supply the given enabled stat
+	 * @param index The stat index
+	 * @return True if the stat is available, false otherwise
+	 */
+	bool is_available(StatIndex index) const override;
+
+	/**
+	 * @brief Retrieve a new sample set
+	 * @param delta_time Time since last sample
+	 */
+	Counters sample(float delta_time) override;
+
+	/**
+	 * @brief Adds a ring buffer to the ones reported
+	 * @param ring_buffer The ring buffer, which must outlive the provider
+	 */
+	void track(const RingBuffer &ring_buffer);
+
+  private:
+	std::vector<const RingBuffer *> ring_buffers;
+
+	std::mutex mutex;
+};
+}        // namespace vkb
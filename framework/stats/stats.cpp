@@ -19,8 +19,12 @@
 #include "stats/stats.h"
 #include "core/device.h"
 
+#include "culling_stats_provider.h"
 #include "frame_time_stats_provider.h"
+#include "gpu_time_stats_provider.h"
 #include "hwcpipe_stats_provider.h"
+#include "perf_event_stats_provider.h"
+#include "ring_buffer_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
 namespace vkb
@@ -63,9 +67,25 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+
+	// Culling counts are also per frame, and are reported directly by the subpasses
+	auto culling = std::make_unique<CullingStatsProvider>(stats);
+	culling_provider = culling.get();
+	providers.emplace_back(std::move(culling));
+
+	auto ring_buffer = std::make_unique<RingBufferStatsProvider>(stats);
+	ring_buffer_provider = ring_buffer.get();
+	providers.emplace_back(std::move(ring_buffer));
+
+	providers.emplace_back(std::make_unique<PerfEventStatsProvider>(stats));
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 	providers.emplace_back(std::make_unique<VulkanStatsProvider>(stats, sampling_config, render_context));
 
+	// The GPU time is measured with plain timestamps when the performance counters do not report it
+	auto gpu_time = std::make_unique<GpuTimeStatsProvider>(stats, render_context);
+	gpu_time_provider = gpu_time.get();
+	providers.emplace_back(std::move(gpu_time));
+
 	// In continuous sampling mode we still need to update the frame times as if we are polling
 	// Store the frame time provider here so we can easily access it later.
 	frame_time_provider = providers[0].get();
@@ -138,6 +158,8 @@ static void add_smoothed_value(std::vector<float> &values, float value, float al
 
 void Stats::update(float delta_time)
 {
+	frame_count++;
+
 	switch (sampling_config.mode)
 	{
 		case CounterSamplingMode::Polling:
@@ -154,6 +176,13 @@ void Stats::update(float delta_time)
 		}
 		case CounterSamplingMode::Continuous:
 		{
+			// Culling counts and GPU times are not continuous, they are sampled every frame so that
+			// the frames without a sample to show do not accumulate into the next one
+			StatsProvider::Counters frame_sample = culling_provider->sample(delta_time);
+
+			auto gpu_time_sample = gpu_time_provider->sample(delta_time);
+			frame_sample.insert(gpu_time_sample.begin(), gpu_time_sample.end());
+
 			// Check that we have no pending samples to be shown
 			if (pending_samples.size() == 0)
 			{
@@ -204,6 +233,7 @@ void Stats::update(float delta_time)
 
 			// Get the frame time stats (not a continuous stat)
 			StatsProvider::Counters frame_time_sample = frame_time_provider->sample(delta_time);
+			frame_time_sample.insert(frame_sample.begin(), frame_sample.end());
 
 			// Push the samples to circular buffers
 			std::for_each(pending_samples.begin(), pending_samples.begin() + sample_count, [this, frame_time_sample](auto &s) {
@@ -275,6 +305,9 @@ void Stats::push_sample(const StatsProvider::Counters &sample)
 
 		float measurement = static_cast<float>(smp->second.result);
 
+		last_values[idx] = measurement;
+		last_frames[idx] = frame_count > smp->second.frame_delay ? frame_count - smp->second.frame_delay : 0;
+
 		add_smoothed_value(values, measurement, alpha_smoothing);
 	}
 }
@@ -297,6 +330,57 @@ void Stats::end_sampling(CommandBuffer &cb)
 	}
 }
 
+void Stats::record_culling(uint32_t visible_count, uint32_t culled_count)
+{
+	if (culling_provider)
+	{
+		culling_provider->record(visible_count, culled_count);
+	}
+}
+
+void Stats::track_ring_buffer(const RingBuffer &ring_buffer)
+{
+	if (ring_buffer_provider)
+	{
+		ring_buffer_provider->track(ring_buffer);
+	}
+}
+
+void Stats::request_gpu_time()
+{
+	if (is_available(StatIndex::gpu_time))
+	{
+		return;
+	}
+
+	if (!gpu_time_provider)
+	{
+		// The sample did not request any stats
+		request_stats({StatIndex::gpu_time});
+		return;
+	}
+
+	if (!gpu_time_provider->enable())
+	{
+		LOGW(vkb::StatsProvider::default_graph_data(StatIndex::gpu_time).name + " : not available");
+		return;
+	}
+
+	counters[StatIndex::gpu_time] = std::vector<float>(buffer_size, 0);
+}
+
+float Stats::get_last_value(StatIndex index) const
+{
+	auto it = last_values.find(index);
+	return it != last_values.end() ? it->second : 0.0f;
+}
+
+uint64_t Stats::get_last_frame(StatIndex index) const
+{
+	auto it = last_frames.find(index);
+	return it != last_frames.end() ? it->second : 0;
+}
+
 const StatGraphData &Stats::get_graph_data(StatIndex index) const
 {
 	for (auto &p : providers)
@@ -34,6 +34,10 @@ namespace vkb
 class Device;
 class CommandBuffer;
 class RenderContext;
+class CullingStatsProvider;
+class GpuTimeStatsProvider;
+class RingBuffer;
+class RingBufferStatsProvider;
 
 /*
  * @brief Helper class for querying statistics about the CPU and the GPU
@@ -61,6 +65,14 @@ class Stats
 	void request_stats(const std::set<StatIndex> &requested_stats,
 	                   CounterSamplingConfig      sampling_config = {CounterSamplingMode::Polling});
 
+	/**
+	 * @brief Collects StatIndex::gpu_time in addition to the stats requested, for tools which need it whatever the sample requests
+	 *
+	 * The time is measured with timestamp queries when no other provider reports it. It is not added to the
+	 * requested stats, so it is not graphed unless the sample requested it too. Must not be called while recording a frame.
+	 */
+	void request_gpu_time();
+
 	/**
 	 * @brief Resizes the stats buffers according to the width of the screen
 	 * @param width The width of the screen
@@ -91,6 +103,21 @@ class Stats
 		return counters.at(index);
 	};
 
+	/**
+	 * @brief Returns the last value sampled for a specific statistic, before smoothing
+	 * @param index The stat index of the data requested
+	 * @return The last value of the specified stat, or 0 if it was not sampled yet
+	 */
+	float get_last_value(StatIndex index) const;
+
+	/**
+	 * @brief Returns the frame the last value of a specific statistic was measured in,
+	 *        which can precede the current frame when the value is read back from the GPU without waiting
+	 * @param index The stat index of the data requested
+	 * @return The number of the frame, counting the calls to update() from 1, or 0 if it was not sampled yet
+	 */
+	uint64_t get_last_frame(StatIndex index) const;
+
 	/**
 	 * @return The requested stats
 	 */
@@ -133,6 +160,22 @@ class Stats
 	 */
 	void end_sampling(CommandBuffer &cb);
 
+	/**
+	 * @brief Reports the results of frustum culling for the frame being recorded
+	 *
+	 * Can be called several times per frame, and from several threads, the counts
+	 * are accumulated until the next update.
+	 * @param visible_count Number of submeshes which passed culling
+	 * @param culled_count Number of submeshes which were culled
+	 */
+	void record_culling(uint32_t visible_count, uint32_t culled_count);
+
+	/**
+	 * @brief Reports the high-water mark of a ring buffer, summed with the other ring buffers tracked
+	 * @param ring_buffer The ring buffer, which must stay alive as long as the stats are updated
+	 */
+	void track_ring_buffer(const RingBuffer &ring_buffer);
+
   private:
 	/// The render context
 	RenderContext &render_context;
@@ -143,6 +186,15 @@ class Stats
 	/// Provider that tracks frame times
 	StatsProvider *frame_time_provider;
 
+	/// Provider that tracks culled submeshes
+	CullingStatsProvider *culling_provider{nullptr};
+
+	/// Provider that tracks the ring buffers
+	RingBufferStatsProvider *ring_buffer_provider{nullptr};
+
+	/// Provider that measures the GPU time with timestamps
+	GpuTimeStatsProvider *gpu_time_provider{nullptr};
+
 	/// A list of stats providers to use in priority order
 	std::vector<std::unique_ptr<StatsProvider>> providers;
 
@@ -164,6 +216,15 @@ class Stats
 	/// Circular buffers for counter data
 	std::map<StatIndex, std::vector<float>> counters{};
 
+	/// Last sampled value of each counter, as measured
+	std::map<StatIndex, float> last_values{};
+
+	/// Frame the last value of each counter was measured in
+	std::map<StatIndex, uint64_t> last_frames{};
+
+	/// Number of calls to update()
+	uint64_t frame_count{0};
+
 	/// Worker thread for continuous sampling
 	std::thread worker_thread;
 
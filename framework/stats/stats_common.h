@@ -63,6 +63,12 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+	gpu_time,
+
+	visible_submeshes,
+	culled_submeshes,
+
+	ring_buffer_peak,
 };
 
 struct StatIndexHash
@@ -54,6 +54,12 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::gpu_time,              {"GPU Time",                                    "{:3.1f} ms",    1000.0f}},
+
+    {StatIndex::visible_submeshes,     {"Visible Submeshes",                           "{:4.0f}"}},
+    {StatIndex::culled_submeshes,      {"Culled Submeshes",                            "{:4.0f}"}},
+
+    {StatIndex::ring_buffer_peak,      {"Ring Buffer High-Water Mark",                 "{:4.0f} KiB",   1.0f / 1024.0f}},
     // clang-format on
 };
 
@@ -36,6 +36,9 @@ class StatsProvider
 	struct Counter
 	{
 		double result;
+
+		/// How many frames ago the result was measured, for providers which read it back from the GPU without waiting
+		uint32_t frame_delay{0};
 	};
 
 	using Counters = std::unordered_map<StatIndex, Counter, StatIndexHash>;
@@ -170,6 +170,12 @@ VulkanStatsProvider::VulkanStatsProvider(std::set<StatIndex>         &requested_
 	{
 		requested_stats.erase(s.first);
 	}
+
+	// The timestamps which bracket the counters also measure the GPU time
+	if (timestamp_pool && requested_stats.erase(StatIndex::gpu_time) > 0)
+	{
+		reports_gpu_time = true;
+	}
 }
 
 VulkanStatsProvider::~VulkanStatsProvider()
@@ -261,6 +267,8 @@ bool VulkanStatsProvider::create_query_pools(uint32_t queue_family_index)
 		return false;
 	}
 
+	query_frames.resize(num_framebuffers, 0);
+
 	// Reset the query pool before first use. We cannot do these in the command buffer
 	// as that is invalid usage for performance queries due to the potential for multple
 	// passes being required.
@@ -319,13 +327,18 @@ bool VulkanStatsProvider::is_supported(const CounterSamplingConfig &sampling_con
 
 bool VulkanStatsProvider::is_available(StatIndex index) const
 {
-	return stat_data.find(index) != stat_data.end();
+	return stat_data.find(index) != stat_data.end() || (index == StatIndex::gpu_time && reports_gpu_time);
 }
 
 const StatGraphData &VulkanStatsProvider::get_graph_data(StatIndex index) const
 {
 	assert(is_available(index) && "VulkanStatsProvider::get_graph_data() called with invalid StatIndex");
 
+	if (index == StatIndex::gpu_time)
+	{
+		return default_graph_map[index];
+	}
+
 	const auto &data = vendor_data.find(index)->second;
 	if (data.has_vendor_graph_data)
 	{
@@ -338,6 +351,13 @@ const StatGraphData &VulkanStatsProvider::get_graph_data(StatIndex index) const
 void VulkanStatsProvider::begin_sampling(CommandBuffer &cb)
 {
 	uint32_t active_frame_idx = render_context.get_active_frame_index();
+	if (query_pool && query_frames[active_frame_idx] != 0)
+	{
+		// The frame this query was used for has completed, but its results were not read in time, drop them
+		query_pool->host_reset(active_frame_idx, 1);
+		query_frames[active_frame_idx] = 0;
+	}
+
 	if (timestamp_pool)
 	{
 		// We use TimestampQueries when available to provide a more accurate delta_time.
@@ -370,7 +390,7 @@ void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 		                     0, 0, nullptr, 0, nullptr, 0, nullptr);
 		cb.end_query(*query_pool, active_frame_idx);
 
-		++queries_ready;
+		query_frames[active_frame_idx] = ++frame_number;
 	}
 
 	if (timestamp_pool)
@@ -404,57 +424,96 @@ static double get_counter_value(const VkPerformanceCounterResultKHR &result,
 	}
 }
 
-float VulkanStatsProvider::get_best_delta_time(float sw_delta_time) const
+bool VulkanStatsProvider::get_gpu_time(uint32_t frame_index, float &gpu_time) const
 {
 	if (!timestamp_pool)
 	{
-		return sw_delta_time;
+		return false;
 	}
 
-	float delta_time = sw_delta_time;
+	// Query the timestamps to get an accurate delta time, each followed by its availability
+	std::array<uint64_t, 4> timestamps;
 
-	// Query the timestamps to get an accurate delta time
-	std::array<uint64_t, 2> timestamps;
-
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
-	VkResult r = timestamp_pool->get_results(active_frame_idx * 2, 2,
+	VkResult r = timestamp_pool->get_results(frame_index * 2, 2,
 	                                         timestamps.size() * sizeof(uint64_t),
-	                                         timestamps.data(), sizeof(uint64_t),
-	                                         VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT);
-	if (r == VK_SUCCESS)
+	                                         timestamps.data(), 2 * sizeof(uint64_t),
+	                                         VK_QUERY_RESULT_WITH_AVAILABILITY_BIT | VK_QUERY_RESULT_64_BIT);
+	if (r != VK_SUCCESS || timestamps[1] == 0 || timestamps[3] == 0)
 	{
-		float elapsed_ns = timestamp_period * static_cast<float>(timestamps[1] - timestamps[0]);
-		delta_time       = elapsed_ns * 0.000000001f;
+		return false;
 	}
 
-	return delta_time;
+	float elapsed_ns = timestamp_period * static_cast<float>(timestamps[2] - timestamps[0]);
+	gpu_time         = elapsed_ns * 0.000000001f;
+
+	return true;
 }
 
 StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 {
 	Counters out;
-	if (!query_pool || queries_ready == 0)
+	if (!query_pool)
 	{
 		return out;
 	}
 
-	uint32_t active_frame_idx = render_context.get_active_frame_index();
-
 	VkDeviceSize stride = sizeof(VkPerformanceCounterResultKHR) * counter_indices.size();
 
 	std::vector<VkPerformanceCounterResultKHR> results(counter_indices.size());
+	std::vector<VkPerformanceCounterResultKHR> frame_results(counter_indices.size());
+
+	// Read the queries of the frames which completed, without waiting for the GPU.
+	// Performance queries do not report their availability, they are not ready until the frame completes.
+	// Only the most recent results are reported, the others are dropped.
+	uint64_t sampled_frame = 0;
+	uint32_t sampled_index = 0;
 
-	VkResult r = query_pool->get_results(active_frame_idx, 1,
-	                                     results.size() * sizeof(VkPerformanceCounterResultKHR),
-	                                     results.data(), stride, VK_QUERY_RESULT_WAIT_BIT);
-	if (r != VK_SUCCESS)
+	for (uint32_t frame_index = 0; frame_index < query_frames.size(); frame_index++)
+	{
+		if (query_frames[frame_index] == 0)
+		{
+			continue;
+		}
+
+		VkResult r = query_pool->get_results(frame_index, 1,
+		                                     frame_results.size() * sizeof(VkPerformanceCounterResultKHR),
+		                                     frame_results.data(), stride, 0);
+		if (r != VK_SUCCESS)
+		{
+			continue;
+		}
+
+		if (query_frames[frame_index] > sampled_frame)
+		{
+			sampled_frame = query_frames[frame_index];
+			sampled_index = frame_index;
+			std::swap(results, frame_results);
+		}
+
+		// The results were read, the query can be used again
+		query_pool->host_reset(frame_index, 1);
+		query_frames[frame_index] = 0;
+	}
+
+	if (sampled_frame == 0)
 	{
 		return out;
 	}
 
+	// The frame being recorded is the one after the last that ended sampling
+	uint32_t frame_delay = static_cast<uint32_t>(frame_number + 1 - sampled_frame);
+
 	// Use timestamps to get a more accurate delta if available
-	delta_time = get_best_delta_time(delta_time);
+	float gpu_time = 0.0f;
+	if (get_gpu_time(sampled_index, gpu_time))
+	{
+		delta_time = gpu_time;
+
+		if (reports_gpu_time)
+		{
+			out[StatIndex::gpu_time].result = gpu_time;
+		}
+	}
 
 	// Parse the results - they are in the order we gave in counter_indices
 	for (const auto &s : stat_data)
@@ -494,10 +553,10 @@ StatsProvider::Counters VulkanStatsProvider::sample(float delta_time)
 		}
 	}
 
-	// Now reset the query we just fetched the results from
-	query_pool->host_reset(active_frame_idx, 1);
-
-	--queries_ready;
+	for (auto &counter : out)
+	{
+		counter.second.frame_delay = frame_delay;
+	}
 
 	return out;
 }
@@ -129,7 +129,13 @@ class VulkanStatsProvider : public StatsProvider
 
 	bool create_query_pools(uint32_t queue_family_index);
 
-	float get_best_delta_time(float sw_delta_time) const;
+	/**
+	 * @brief Reads the time the GPU spent executing the sampled command buffer of a frame, without waiting for it
+	 * @param frame_index The index of the render frame the command buffer was recorded for
+	 * @param gpu_time Set to the time in seconds
+	 * @return False if timestamps are not supported or not available yet
+	 */
+	bool get_gpu_time(uint32_t frame_index, float &gpu_time) const;
 
   private:
 	// The render context
@@ -147,6 +153,9 @@ class VulkanStatsProvider : public StatsProvider
 	// Query pool for timestamps
 	std::unique_ptr<QueryPool> timestamp_pool;
 
+	// Whether the time measured by the timestamps is reported as StatIndex::gpu_time
+	bool reports_gpu_time{false};
+
 	// Map of vendor specific stat data
 	VendorStatMap vendor_data;
 
@@ -156,8 +165,11 @@ class VulkanStatsProvider : public StatsProvider
 	// An ordered list of the Vulkan counter ids
 	std::vector<uint32_t> counter_indices;
 
-	// How many queries have been ended?
-	uint32_t queries_ready = 0;
+	// The number of frames which ended sampling
+	uint64_t frame_number{0};
+
+	// For each render frame, the number of the frame whose query results were not read yet, or 0
+	std::vector<uint64_t> query_frames;
 };
 
 }        // namespace vkb
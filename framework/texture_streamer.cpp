@@ -0,0 +1,383 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "texture_streamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "common/logging.h"
+#include "core/device.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/texture.h"
+
+#include <ctpl_stl.h>
+
+namespace vkb
+{
+namespace
+{
+// Mips up to this size are uploaded as soon as an image is decoded, whatever the memory budget
+const uint32_t TAIL_MIPMAP_SIZE = 64;
+
+// Amount of data uploaded per frame, at least one image is uploaded per frame whatever its size
+const VkDeviceSize MAX_UPLOAD_SIZE_PER_FRAME = 8 * 1024 * 1024;
+
+// The uploads of a frame fit in the staging ring while those of the previous frame are in flight,
+// mips larger than half of it get a dedicated staging buffer
+const VkDeviceSize STAGING_SIZE = 2 * MAX_UPLOAD_SIZE_PER_FRAME;
+}        // namespace
+
+TextureStreamer::TextureStreamer(Device &device, VkDeviceSize memory_budget, uint32_t frames_in_flight) :
+    Script{"TextureStreamer"},
+    device{device},
+    memory_budget{memory_budget},
+    frames_in_flight{frames_in_flight},
+    upload_manager{device, STAGING_SIZE}
+{
+	auto thread_count = std::thread::hardware_concurrency();
+	thread_count      = thread_count == 0 ? 1 : thread_count;
+	thread_pool       = std::make_unique<ctpl::thread_pool>(thread_count);
+
+	create_placeholder();
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	// Let the decoding complete, as the tasks still refer to their data
+	thread_pool->stop(true);
+
+	// The images of the uploads in flight are released before the upload manager
+	upload_manager.wait_idle();
+}
+
+void TextureStreamer::add_image(sg::Image &image, std::function<std::unique_ptr<sg::Image>()> &&decode)
+{
+	StreamedImage streamed_image;
+	streamed_image.decoding = thread_pool->push([decode](size_t) {
+		sg::ImageWorkerScope image_worker;
+		return decode();
+	});
+
+	image_indices[&image] = images.size();
+	images.push_back(std::move(streamed_image));
+}
+
+void TextureStreamer::add_texture(sg::Texture &texture)
+{
+	auto it = image_indices.find(texture.get_image());
+	if (it == image_indices.end())
+	{
+		return;
+	}
+
+	auto &streamed_image = images[it->second];
+	streamed_image.textures.push_back(&texture);
+
+	texture.set_image_view(streamed_image.image_view ? streamed_image.image_view.get() : placeholder_image_view.get());
+}
+
+void TextureStreamer::coerce_format_to_srgb(const sg::Image &image)
+{
+	auto it = image_indices.find(&image);
+	if (it != image_indices.end())
+	{
+		images[it->second].srgb = true;
+	}
+}
+
+void TextureStreamer::update(float /*delta_time*/)
+{
+	frame_count++;
+
+	// Release the images replaced, once the frames which may still sample them completed
+	retired_images.erase(std::remove_if(retired_images.begin(), retired_images.end(),
+	                                    [this](const RetiredImage &retired_image) { return retired_image.frame + frames_in_flight < frame_count; }),
+	                     retired_images.end());
+
+	upload_manager.update();
+
+	complete_uploads();
+
+	collect_decoded_images();
+
+	submit_uploads();
+
+	if (uploads.empty())
+	{
+		// Nothing could be uploaded, so the images which are resident already cannot fit more mips in the budget
+		for (auto &streamed_image : images)
+		{
+			if (streamed_image.image)
+			{
+				streamed_image.source.reset();
+			}
+		}
+	}
+}
+
+bool TextureStreamer::is_complete() const
+{
+	if (!uploads.empty())
+	{
+		return false;
+	}
+
+	// Sources are released once their images cannot get more detail
+	return std::none_of(images.begin(), images.end(), [](const StreamedImage &streamed_image) {
+		return streamed_image.decoding.valid() || streamed_image.source;
+	});
+}
+
+VkDeviceSize TextureStreamer::get_resident_size() const
+{
+	return resident_size;
+}
+
+VkDeviceSize TextureStreamer::get_size_from_level(const StreamedImage &streamed_image, uint32_t level) const
+{
+	VkDeviceSize size = 0;
+
+	for (size_t i = level; i < streamed_image.mipmap_sizes.size(); i++)
+	{
+		size += streamed_image.mipmap_sizes[i];
+	}
+
+	return size;
+}
+
+void TextureStreamer::create_placeholder()
+{
+	// A white texel, sampled until the images are decoded
+	placeholder_image      = std::make_unique<core::Image>(device, VkExtent3D{1, 1, 1}, VK_FORMAT_R8G8B8A8_UNORM,
+                                                      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                                      VMA_MEMORY_USAGE_GPU_ONLY);
+	placeholder_image_view = std::make_unique<core::ImageView>(*placeholder_image, VK_IMAGE_VIEW_TYPE_2D);
+
+	const uint32_t white = 0xFFFFFFFF;
+
+	VkBufferImageCopy copy_region{};
+	copy_region.imageSubresource = placeholder_image_view->get_subresource_layers();
+	copy_region.imageExtent      = {1, 1, 1};
+
+	upload_manager.upload(*placeholder_image_view, reinterpret_cast<const uint8_t *>(&white), sizeof(white), {copy_region});
+
+	upload_manager.flush().wait();
+}
+
+void TextureStreamer::complete_uploads()
+{
+	// Uploads are not waited for, the ones in flight are checked again next frame
+	auto in_flight = std::partition(uploads.begin(), uploads.end(), [](const Upload &upload) {
+		return upload.completion.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+	});
+
+	for (auto it = in_flight; it != uploads.end(); ++it)
+	{
+		auto &upload         = *it;
+		auto &streamed_image = images[upload.image_index];
+
+		if (streamed_image.image)
+		{
+			retired_images.push_back({frame_count, std::move(streamed_image.image), std::move(streamed_image.image_view)});
+		}
+
+		streamed_image.image          = std::move(upload.image);
+		streamed_image.image_view     = std::move(upload.image_view);
+		streamed_image.resident_level = upload.resident_level;
+		streamed_image.uploading      = false;
+
+		for (auto texture : streamed_image.textures)
+		{
+			texture->set_image_view(streamed_image.image_view.get());
+		}
+
+		// The data is not needed anymore once all the mips are resident
+		if (streamed_image.resident_level == 0)
+		{
+			streamed_image.source.reset();
+		}
+	}
+
+	uploads.erase(in_flight, uploads.end());
+}
+
+void TextureStreamer::collect_decoded_images()
+{
+	for (auto &streamed_image : images)
+	{
+		if (!streamed_image.decoding.valid() ||
+		    streamed_image.decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			continue;
+		}
+
+		streamed_image.source = streamed_image.decoding.get();
+
+		auto &source = *streamed_image.source;
+
+		if (streamed_image.srgb)
+		{
+			source.coerce_format_to_srgb();
+		}
+
+		if (source.get_layers() > 1)
+		{
+			LOGW("Streaming image {} with {} layers, only the first one is used", source.get_name(), source.get_layers());
+		}
+
+		streamed_image.mipmaps = source.get_mipmaps();
+		std::sort(streamed_image.mipmaps.begin(), streamed_image.mipmaps.end(),
+		          [](const sg::Mipmap &lhs, const sg::Mipmap &rhs) { return lhs.level < rhs.level; });
+
+		// Mips are not stored in the order of their level in every container, so sizes are deduced from the offsets
+		std::vector<uint32_t> offsets;
+		for (auto &mipmap : streamed_image.mipmaps)
+		{
+			offsets.push_back(mipmap.offset);
+		}
+		offsets.push_back(to_u32(source.get_data().size() / source.get_layers()));
+		std::sort(offsets.begin(), offsets.end());
+
+		for (auto &mipmap : streamed_image.mipmaps)
+		{
+			auto next_offset = std::upper_bound(offsets.begin(), offsets.end(), mipmap.offset);
+			streamed_image.mipmap_sizes.push_back(*next_offset - mipmap.offset);
+		}
+
+		streamed_image.resident_level = to_u32(streamed_image.mipmaps.size());
+	}
+}
+
+void TextureStreamer::submit_uploads()
+{
+	VkDeviceSize upload_size = 0;
+
+	auto schedule = [&](size_t image_index, uint32_t level) {
+		auto &streamed_image = images[image_index];
+
+		auto size = get_size_from_level(streamed_image, level);
+
+		resident_size += size;
+		resident_size -= get_size_from_level(streamed_image, streamed_image.resident_level);
+		upload_size += size;
+
+		record_upload(image_index, level);
+	};
+
+	// Upload the smallest mips of the images decoded first, so that they all get some detail quickly
+	for (size_t i = 0; i < images.size() && upload_size < MAX_UPLOAD_SIZE_PER_FRAME; i++)
+	{
+		auto &streamed_image = images[i];
+
+		if (!streamed_image.source || streamed_image.image || streamed_image.uploading)
+		{
+			continue;
+		}
+
+		uint32_t level = 0;
+		while (level + 1 < streamed_image.mipmaps.size() &&
+		       std::max(streamed_image.mipmaps[level].extent.width, streamed_image.mipmaps[level].extent.height) > TAIL_MIPMAP_SIZE)
+		{
+			level++;
+		}
+
+		schedule(i, level);
+	}
+
+	// Then bring in the larger mips, as far as the memory budget allows
+	for (size_t i = 0; i < images.size() && upload_size < MAX_UPLOAD_SIZE_PER_FRAME; i++)
+	{
+		auto &streamed_image = images[i];
+
+		if (!streamed_image.source || !streamed_image.image || streamed_image.uploading || streamed_image.resident_level == 0)
+		{
+			continue;
+		}
+
+		auto resident_image_size = get_size_from_level(streamed_image, streamed_image.resident_level);
+
+		uint32_t level = streamed_image.resident_level;
+		while (level > 0 && resident_size - resident_image_size + get_size_from_level(streamed_image, level - 1) <= memory_budget)
+		{
+			level--;
+		}
+
+		if (level < streamed_image.resident_level)
+		{
+			schedule(i, level);
+		}
+	}
+
+	if (upload_size > 0)
+	{
+		upload_manager.flush();
+	}
+}
+
+void TextureStreamer::record_upload(size_t image_index, uint32_t level)
+{
+	auto &streamed_image = images[image_index];
+	auto &source         = *streamed_image.source;
+
+	auto level_count = to_u32(streamed_image.mipmaps.size()) - level;
+
+	Upload upload{};
+	upload.image_index    = image_index;
+	upload.resident_level = level;
+	upload.image          = std::make_unique<core::Image>(device,
+                                                 streamed_image.mipmaps[level].extent,
+                                                 source.get_format(),
+                                                 VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                                                 VMA_MEMORY_USAGE_GPU_ONLY,
+                                                 VK_SAMPLE_COUNT_1_BIT,
+                                                 level_count);
+	upload.image->set_debug_name(source.get_name());
+	upload.image_view = std::make_unique<core::ImageView>(*upload.image, VK_IMAGE_VIEW_TYPE_2D);
+
+	// Whether the container stores the mips from the largest or the smallest, the ones from a level are contiguous
+	VkDeviceSize begin = std::numeric_limits<VkDeviceSize>::max();
+	VkDeviceSize end   = 0;
+	for (uint32_t i = level; i < streamed_image.mipmaps.size(); i++)
+	{
+		begin = std::min<VkDeviceSize>(begin, streamed_image.mipmaps[i].offset);
+		end   = std::max<VkDeviceSize>(end, streamed_image.mipmaps[i].offset + streamed_image.mipmap_sizes[i]);
+	}
+
+	std::vector<VkBufferImageCopy> copy_regions;
+
+	for (uint32_t i = level; i < streamed_image.mipmaps.size(); i++)
+	{
+		auto &mipmap = streamed_image.mipmaps[i];
+
+		VkBufferImageCopy copy_region{};
+		copy_region.bufferOffset              = mipmap.offset - begin;
+		copy_region.imageSubresource          = upload.image_view->get_subresource_layers();
+		copy_region.imageSubresource.mipLevel = i - level;
+		copy_region.imageExtent               = mipmap.extent;
+
+		copy_regions.push_back(copy_region);
+	}
+
+	upload.completion = upload_manager.upload(*upload.image_view, source.get_data().data() + begin, end - begin, std::move(copy_regions));
+
+	streamed_image.uploading = true;
+
+	uploads.push_back(std::move(upload));
+}
+}        // namespace vkb
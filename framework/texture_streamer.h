@@ -0,0 +1,202 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "core/upload_manager.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/script.h"
+
+namespace ctpl
+{
+class thread_pool;
+}        // namespace ctpl
+
+namespace vkb
+{
+class Device;
+
+namespace sg
+{
+class Texture;
+}        // namespace sg
+
+/**
+ * @brief Streams the images of a scene in the background, so that the scene can be rendered before they are loaded.
+ *
+ * Images are decoded on worker threads. Once an image is decoded, its smallest mips are uploaded first, then the
+ * larger ones, as long as the images stay within the memory budget. The textures sampling an image are pointed to a
+ * view of its resident mips, or to a placeholder while it is decoded.
+ *
+ * The streamer is a script of the scene, so that it is updated every frame. Uploads go through an UploadManager, so
+ * they run on the transfer queue alongside rendering. They are submitted and views swapped from the update, while
+ * the views replaced are kept alive until the frames in flight which may use them completed.
+ */
+class TextureStreamer : public sg::Script
+{
+  public:
+	/**
+	 * @brief Creates a texture streamer
+	 * @param device The device the images are uploaded to
+	 * @param memory_budget The amount of memory the resident mips of all the images may use
+	 * @param frames_in_flight The number of frames which may use a view after it was replaced
+	 */
+	TextureStreamer(Device &device, VkDeviceSize memory_budget, uint32_t frames_in_flight);
+
+	virtual ~TextureStreamer();
+
+	/**
+	 * @brief Queues an image to be decoded on a worker thread
+	 * @param image The image component of the scene, which stays empty as its data is streamed
+	 * @param decode Function decoding the image, with its mipmaps
+	 */
+	void add_image(sg::Image &image, std::function<std::unique_ptr<sg::Image>()> &&decode);
+
+	/**
+	 * @brief Makes a texture sample the resident mips of its image, which has to be added first
+	 * @param texture The texture to update as the image is streamed
+	 */
+	void add_texture(sg::Texture &texture);
+
+	/**
+	 * @brief Makes an image be uploaded with the sRGB variant of its decoded format
+	 *        The empty image of the scene is coerced by the materials, so the streamer has to apply it to the data it decodes.
+	 * @param image The image component of the scene, which has to be added first
+	 */
+	void coerce_format_to_srgb(const sg::Image &image);
+
+	/**
+	 * @brief Collects the decoded images, swaps the views of the uploads which completed and submits new uploads
+	 */
+	void update(float delta_time) override;
+
+	/**
+	 * @return Whether all the images were decoded and are as resident as the memory budget allows
+	 */
+	bool is_complete() const;
+
+	/**
+	 * @return The amount of memory used by the resident mips of the images
+	 */
+	VkDeviceSize get_resident_size() const;
+
+  private:
+	struct StreamedImage
+	{
+		std::future<std::unique_ptr<sg::Image>> decoding;
+
+		/// The decoded data, released once all the mips are resident
+		std::unique_ptr<sg::Image> source;
+
+		/// The mipmaps of the source, sorted by level, and the size of their data
+		std::vector<sg::Mipmap> mipmaps;
+
+		std::vector<VkDeviceSize> mipmap_sizes;
+
+		std::unique_ptr<core::Image> image;
+
+		std::unique_ptr<core::ImageView> image_view;
+
+		/// First mip level resident, the number of mipmaps when none is
+		uint32_t resident_level{0};
+
+		/// Whether an upload of the image is in flight
+		bool uploading{false};
+
+		/// Whether the image holds colors, which are sampled with sRGB decoding
+		bool srgb{false};
+
+		std::vector<sg::Texture *> textures;
+	};
+
+	struct Upload
+	{
+		size_t image_index;
+
+		uint32_t resident_level;
+
+		std::unique_ptr<core::Image> image;
+
+		std::unique_ptr<core::ImageView> image_view;
+
+		std::shared_future<void> completion;
+	};
+
+	struct RetiredImage
+	{
+		uint64_t frame;
+
+		std::unique_ptr<core::Image> image;
+
+		std::unique_ptr<core::ImageView> image_view;
+	};
+
+	/**
+	 * @return The size of the mips of an image from the given level
+	 */
+	VkDeviceSize get_size_from_level(const StreamedImage &streamed_image, uint32_t level) const;
+
+	/**
+	 * @brief Creates an image holding the mips of an image from the given level, and records their upload
+	 */
+	void record_upload(size_t image_index, uint32_t level);
+
+	void create_placeholder();
+
+	void complete_uploads();
+
+	void collect_decoded_images();
+
+	void submit_uploads();
+
+	Device &device;
+
+	VkDeviceSize memory_budget;
+
+	uint32_t frames_in_flight;
+
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
+
+	UploadManager upload_manager;
+
+	std::vector<StreamedImage> images;
+
+	std::unordered_map<const sg::Image *, size_t> image_indices;
+
+	std::unique_ptr<core::Image> placeholder_image;
+
+	std::unique_ptr<core::ImageView> placeholder_image_view;
+
+	std::vector<Upload> uploads;
+
+	std::vector<RetiredImage> retired_images;
+
+	uint64_t frame_count{0};
+
+	VkDeviceSize resident_size{0};
+};
+}        // namespace vkb
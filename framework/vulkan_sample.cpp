@@ -57,6 +57,7 @@ VulkanSample::~VulkanSample()
 	stats.reset();
 	gui.reset();
 	render_context.reset();
+	profiler.reset();
 	device.reset();
 
 	if (surface != VK_NULL_HANDLE)
@@ -204,6 +205,12 @@ bool VulkanSample::prepare(Platform &platform)
 
 	stats = std::make_unique<vkb::Stats>(*render_context);
 
+	profiler = std::make_unique<vkb::Profiler>(*device);
+	for (auto &frame : render_context->get_render_frames())
+	{
+		frame->set_profiler(profiler.get());
+	}
+
 	// Start the sample in the first GUI configuration
 	configuration.reset();
 
@@ -310,6 +317,7 @@ void VulkanSample::update(float delta_time)
 
 	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 	stats->begin_sampling(command_buffer);
+	profiler->reset_queries(command_buffer);
 
 	draw(command_buffer, render_context->get_active_frame().get_render_target());
 
@@ -536,6 +544,17 @@ void VulkanSample::set_viewport_and_scissor(vkb::CommandBuffer &command_buffer,
 void VulkanSample::load_scene(const std::string &path)
 {
 	GLTFLoader loader{*device};
+	loader.set_packed_geometry(packed_geometry);
+	loader.set_mesh_optimization(mesh_optimization);
+	loader.set_scene_cache(scene_cache);
+
+	if (texture_streaming_budget > 0)
+	{
+		// Views replaced by the streamer may still be used by the frames in flight
+		auto frames_in_flight = render_context ? to_u32(render_context->get_render_frames().size()) : 3;
+
+		loader.set_texture_streamer(std::make_unique<TextureStreamer>(*device, texture_streaming_budget, frames_in_flight));
+	}
 
 	scene = loader.read_scene_from_file(path);
 
@@ -557,6 +576,16 @@ RenderContext &VulkanSample::get_render_context()
 	return *render_context;
 }
 
+Stats *VulkanSample::get_stats()
+{
+	return stats.get();
+}
+
+Profiler *VulkanSample::get_profiler()
+{
+	return profiler.get();
+}
+
 const std::vector<const char *> VulkanSample::get_validation_layers()
 {
 	return {};
@@ -27,6 +27,7 @@
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
 #include "scene_graph/scripts/node_animation.h"
+#include "stats/profiler.h"
 #include "stats/stats.h"
 
 namespace vkb
@@ -147,6 +148,17 @@ class VulkanSample : public Application
 
 	RenderContext &get_render_context();
 
+	/**
+	 * @return The statistics of the sample, or nullptr if it is not prepared
+	 */
+	Stats *get_stats();
+
+	/**
+	 * @return The profiler of the scopes recorded by the sample, disabled until the GUI or the sample enables it,
+	 *         or nullptr if the sample is not prepared
+	 */
+	Profiler *get_profiler();
+
 	void set_render_pipeline(RenderPipeline &&render_pipeline);
 
 	RenderPipeline &get_render_pipeline();
@@ -187,6 +199,8 @@ class VulkanSample : public Application
 
 	std::unique_ptr<Stats> stats{nullptr};
 
+	std::unique_ptr<Profiler> profiler{nullptr};
+
 	/**
 	 * @brief Update scene
 	 * @param delta_time
@@ -304,6 +318,8 @@ class VulkanSample : public Application
 
 	static constexpr float STATS_VIEW_RESET_TIME{10.0f};        // 10 seconds
 
+	static constexpr VkDeviceSize DEFAULT_TEXTURE_STREAMING_BUDGET{256 * 1024 * 1024};        // 256 MB
+
 	/**
 	 * @brief The Vulkan surface
 	 */
@@ -326,6 +342,48 @@ class VulkanSample : public Application
 		high_priority_graphics_queue = enable;
 	}
 
+	/**
+	 * @brief Sets whether load_scene keeps the decoded images and the geometry of the scene in a cache,
+	 * so that loading the scene again skips decoding them.
+	 * Needs to be called before load_scene().
+	 * @param enable If true, the scene cache is read and written. Default state is false.
+	 */
+	void set_scene_cache_enable(bool enable)
+	{
+		scene_cache = enable;
+	}
+
+	/**
+	 * @brief Sets whether load_scene packs the geometry of all the meshes into shared buffers.
+	 * Needs to be called before load_scene().
+	 * @param enable If true, the geometry is packed. Default state is false.
+	 */
+	void set_packed_geometry_enable(bool enable)
+	{
+		packed_geometry = enable;
+	}
+
+	/**
+	 * @brief Sets whether load_scene streams the images in the background once the scene is loaded.
+	 * Needs to be called before load_scene().
+	 * @param enable If true, the images are streamed. Default state is false.
+	 * @param memory_budget The amount of memory the resident mips of all the images may use
+	 */
+	void set_texture_streaming_enable(bool enable, VkDeviceSize memory_budget = DEFAULT_TEXTURE_STREAMING_BUDGET)
+	{
+		texture_streaming_budget = enable ? memory_budget : 0;
+	}
+
+	/**
+	 * @brief Sets whether load_scene reorders the triangles and vertices of the meshes for the vertex cache and overdraw.
+	 * Needs to be called before load_scene().
+	 * @param enable If true, the meshes are optimized. Default state is false.
+	 */
+	void set_mesh_optimization_enable(bool enable)
+	{
+		mesh_optimization = enable;
+	}
+
   private:
 	/** @brief Set of device extensions to be enabled for this example and whether they are optional (must be set in the derived constructor) */
 	std::unordered_map<const char *, bool> device_extensions;
@@ -338,5 +396,17 @@ class VulkanSample : public Application
 
 	/** @brief Whether or not we want a high priority graphics queue. */
 	bool high_priority_graphics_queue{false};
+
+	/** @brief Whether or not the scenes are loaded through a scene cache. */
+	bool scene_cache{false};
+
+	/** @brief Whether or not the geometry of the scenes is packed into shared buffers. */
+	bool packed_geometry{false};
+
+	/** @brief The memory budget of the streamed images of the scenes, they are not streamed if 0. */
+	VkDeviceSize texture_streaming_budget{0};
+
+	/** @brief Whether or not the meshes of the scenes are optimized. */
+	bool mesh_optimization{false};
 };
 }        // namespace vkb
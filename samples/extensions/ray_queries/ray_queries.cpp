@@ -292,7 +292,9 @@ void RayQueries::load_scene()
 	model = {};
 
 	vkb::GLTFLoader loader{*device};
-	auto            scene = loader.read_scene_from_file("scenes/sponza/Sponza01.gltf");
+	// The geometry is read back on the CPU to build the acceleration structures
+	loader.set_staged_geometry_upload(false);
+	auto scene = loader.read_scene_from_file("scenes/sponza/Sponza01.gltf");
 
 	for (auto &&mesh : scene->get_components<vkb::sg::Mesh>())
 	{
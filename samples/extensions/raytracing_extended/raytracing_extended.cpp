@@ -1477,6 +1477,8 @@ std::unique_ptr<vkb::VulkanSample> create_raytracing_extended()
 RaytracingExtended::RaytracingScene::RaytracingScene(vkb::Device &device, const std::vector<SceneLoadInfo> &scenesToLoad)
 {
 	vkb::GLTFLoader loader{device};
+	// Vertices and indices are copied out of the mapped scene buffers below
+	loader.set_staged_geometry_upload(false);
 	scenes.resize(scenesToLoad.size());
 	for (size_t sceneIndex = 0; sceneIndex < scenesToLoad.size(); ++sceneIndex)
 	{
@@ -1501,13 +1503,12 @@ RaytracingExtended::RaytracingScene::RaytracingScene(vkb::Device &device, const
 						continue;
 					}
 
-					const auto name             = texture->get_image()->get_name();
-					is_vase                     = (name.find("vase_dif.ktx") != std::basic_string<char>::npos);
-					textureIndex                = imageInfos.size();
-					auto                  image = texture->get_image();
+					const auto name = texture->get_image()->get_name();
+					is_vase         = (name.find("vase_dif.ktx") != std::basic_string<char>::npos);
+					textureIndex    = imageInfos.size();
 					VkDescriptorImageInfo imageInfo;
 					imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-					imageInfo.imageView   = image->get_vk_image_view().get_handle();
+					imageInfo.imageView   = texture->get_image_view().get_handle();
 					imageInfo.sampler     = baseTextureIter->second->get_sampler()->vk_sampler.get_handle();
 					imageInfos.push_back(imageInfo);
 				}
@@ -57,6 +57,8 @@ bool CommandBufferUsage::prepare(vkb::Platform &platform)
 		return false;
 	}
 
+	// The meshes share their vertex and index buffers, so the draws of the secondary command buffers bind fewer buffers
+	set_packed_geometry_enable(true);
 	load_scene("scenes/bonza/Bonza4X.gltf");
 
 	auto &camera_node = vkb::add_free_camera(*scene, "main_camera", get_render_context().get_surface_extent());
@@ -66,12 +68,19 @@ bool CommandBufferUsage::prepare(vkb::Platform &platform)
 	vkb::ShaderSource frag_shader("base.frag");
 	auto              scene_subpass = std::make_unique<ForwardSubpassSecondary>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
 
+	// Only the meshes in view are recorded, the stats show how many draws culling saves
+	scene_subpass->set_frustum_culling(true);
+	scene_subpass->set_stats(stats.get());
+
 	auto render_pipeline = vkb::RenderPipeline();
 	render_pipeline.add_subpass(std::move(scene_subpass));
 
 	set_render_pipeline(std::move(render_pipeline));
 
-	stats->request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::cpu_cycles});
+	stats->request_stats({vkb::StatIndex::frame_times,
+	                      vkb::StatIndex::cpu_cycles,
+	                      vkb::StatIndex::visible_submeshes,
+	                      vkb::StatIndex::culled_submeshes});
 
 	gui = std::make_unique<vkb::Gui>(*this, platform.get_window(), stats.get());
 
@@ -98,6 +107,12 @@ void CommandBufferUsage::prepare_render_context()
 {
 	max_thread_count = std::max(std::thread::hardware_concurrency(), MIN_THREAD_COUNT);
 	get_render_context().prepare(max_thread_count);
+
+	// Recording threads share the buffer pools of each frame
+	for (auto &render_frame : get_render_context().get_render_frames())
+	{
+		render_frame->set_shared_buffer_pools(true);
+	}
 }
 
 void CommandBufferUsage::update(float delta_time)
@@ -288,26 +303,23 @@ vkb::CommandBuffer *CommandBufferUsage::ForwardSubpassSecondary::record_draw_sec
 
 void CommandBufferUsage::ForwardSubpassSecondary::draw(vkb::CommandBuffer &primary_command_buffer)
 {
-	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> opaque_nodes;
-
-	std::multimap<float, std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> transparent_nodes;
-
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
-
-	// Sort opaque objects in front-to-back order
+	// Sort opaque objects in front-to-back order, and transparent objects in back-to-front order
 	// Note: sorting objects does not help on PowerVR, so it can be avoided to save CPU cycles
+	get_sorted_nodes(opaque_draws, transparent_draws);
+
 	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_opaque_nodes;
-	for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
+	sorted_opaque_nodes.reserve(opaque_draws.size());
+	for (auto &draw_item : opaque_draws.get_items())
 	{
-		sorted_opaque_nodes.push_back(node_it->second);
+		sorted_opaque_nodes.emplace_back(draw_item.node, draw_item.sub_mesh);
 	}
 	const auto opaque_submeshes = vkb::to_u32(sorted_opaque_nodes.size());
 
-	// Sort transparent objects in back-to-front order
 	std::vector<std::pair<vkb::sg::Node *, vkb::sg::SubMesh *>> sorted_transparent_nodes;
-	for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
+	sorted_transparent_nodes.reserve(transparent_draws.size());
+	for (auto &draw_item : transparent_draws.get_items())
 	{
-		sorted_transparent_nodes.push_back(node_it->second);
+		sorted_transparent_nodes.emplace_back(draw_item.node, draw_item.sub_mesh);
 	}
 	const auto transparent_submeshes = vkb::to_u32(sorted_transparent_nodes.size());
 
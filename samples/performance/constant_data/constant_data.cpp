@@ -355,10 +355,8 @@ void ConstantData::DescriptorSetSubpass::update_uniform(vkb::CommandBuffer &comm
 
 	mvp = fill_mvp(node, camera);
 
-	// Ensure the container doesn't hold more bytes than are needed
-	auto data = vkb::to_bytes(mvp);
-	data.resize(struct_size);
-	allocation.update(data);
+	// Only upload the bytes which are needed
+	allocation.update_data(reinterpret_cast<const uint8_t *>(&mvp), struct_size);
 
 	command_buffer.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), 0, 1, 0);
 }
@@ -25,6 +25,12 @@
 #include "rendering/subpasses/forward_subpass.h"
 #include "stats/stats.h"
 
+namespace
+{
+/// Initial size of the uniform ring buffer, it grows if the frames in flight need more
+const VkDeviceSize uniform_ring_buffer_size = 256 * 1024;
+}        // namespace
+
 DescriptorManagement::DescriptorManagement()
 {
 	auto &config = get_configuration();
@@ -36,6 +42,15 @@ DescriptorManagement::DescriptorManagement()
 	config.insert<vkb::IntSetting>(1, buffer_allocation.value, 1);
 }
 
+DescriptorManagement::~DescriptorManagement()
+{
+	if (device)
+	{
+		// The frames in flight may still read the uniforms from the ring buffer
+		device->wait_idle();
+	}
+}
+
 bool DescriptorManagement::prepare(vkb::Platform &platform)
 {
 	if (!VulkanSample::prepare(platform))
@@ -52,13 +67,17 @@ bool DescriptorManagement::prepare(vkb::Platform &platform)
 
 	vkb::ShaderSource vert_shader("base.vert");
 	vkb::ShaderSource frag_shader("base.frag");
-	auto              scene_subpass   = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
+	auto              subpass         = std::make_unique<vkb::ForwardSubpass>(get_render_context(), std::move(vert_shader), std::move(frag_shader), *scene, *camera);
 	auto              render_pipeline = vkb::RenderPipeline();
-	render_pipeline.add_subpass(std::move(scene_subpass));
+	scene_subpass                     = subpass.get();
+	render_pipeline.add_subpass(std::move(subpass));
 	set_render_pipeline(std::move(render_pipeline));
 
+	uniform_ring_buffer = std::make_unique<vkb::RingBuffer>(get_device(), uniform_ring_buffer_size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+
 	// Add a GUI with the stats you want to monitor
-	stats->request_stats({vkb::StatIndex::frame_times});
+	stats->request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::ring_buffer_peak});
+	stats->track_ring_buffer(*uniform_ring_buffer);
 	gui = std::make_unique<vkb::Gui>(*this, platform.get_window(), stats.get());
 
 	return true;
@@ -72,6 +91,14 @@ void DescriptorManagement::update(float delta_time)
 
 	auto &render_context = get_render_context();
 
+	// The ring buffer replaces the uniform buffer pools of all the frames, it is set before the next frame
+	// starts so that the ring reclaims the memory that frame used the last time it was in flight
+	auto ring_buffer = (buffer_allocation.value == 2) ? uniform_ring_buffer.get() : nullptr;
+	for (auto &render_frame : render_context.get_render_frames())
+	{
+		render_frame->set_ring_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, ring_buffer);
+	}
+
 	auto &command_buffer = render_context.begin();
 
 	update_stats(delta_time);
@@ -83,6 +110,9 @@ void DescriptorManagement::update(float delta_time)
 
 	render_context.get_active_frame().set_buffer_allocation_strategy(buffer_alloc_strategy);
 
+	// The uniforms of all the draws are written into a few allocations, and selected with dynamic offsets
+	scene_subpass->set_uniform_batching(buffer_allocation.value == 3);
+
 	auto descriptor_management_strategy = (descriptor_caching.value == 0) ?
 	                                          vkb::DescriptorManagementStrategy::CreateDirectly :
 	                                          vkb::DescriptorManagementStrategy::StoreInCache;
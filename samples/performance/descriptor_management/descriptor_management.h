@@ -18,6 +18,8 @@
 #pragma once
 
 #include "rendering/render_pipeline.h"
+#include "rendering/subpasses/geometry_subpass.h"
+#include "ring_buffer.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "vulkan_sample.h"
 
@@ -28,7 +30,7 @@ class DescriptorManagement : public vkb::VulkanSample
 
 	virtual bool prepare(vkb::Platform &platform) override;
 
-	virtual ~DescriptorManagement() = default;
+	virtual ~DescriptorManagement();
 
 	virtual void update(float delta_time) override;
 
@@ -51,13 +53,19 @@ class DescriptorManagement : public vkb::VulkanSample
 
 	RadioButtonGroup buffer_allocation{
 	    "Single large VkBuffer",
-	    {"Disabled", "Enabled"},
+	    {"Disabled", "Enabled", "Ring buffer", "Batched"},
 	    0};
 
 	std::vector<RadioButtonGroup *> radio_buttons = {&descriptor_caching, &buffer_allocation};
 
 	vkb::sg::PerspectiveCamera *camera{nullptr};
 
+	/// The subpass drawing the scene, which batches its uniforms when the "Batched" option is selected
+	vkb::GeometrySubpass *scene_subpass{nullptr};
+
+	/// Shared by all the frames, the uniforms are streamed through it when the ring buffer option is selected
+	std::unique_ptr<vkb::RingBuffer> uniform_ring_buffer;
+
 	virtual void draw_gui() override;
 };
 
@@ -45,6 +45,8 @@ bool LayoutTransitions::prepare(vkb::Platform &platform)
 		return false;
 	}
 
+	// The textures of Sponza are streamed, so the scene is rendered while they are decoded
+	set_texture_streaming_enable(true);
 	load_scene("scenes/sponza/Sponza01.gltf");
 
 	auto &camera_node = vkb::add_free_camera(*scene, "main_camera", get_render_context().get_surface_extent());
@@ -305,6 +305,8 @@ void MultiDrawIndirect::load_scene()
 {
 	assert(!!device);
 	vkb::GLTFLoader   loader{*device};
+	// The geometry is read back on the CPU to fill the buffers of the sample
+	loader.set_staged_geometry_upload(false);
 	const std::string scene_path = "scenes/vokselia/";
 	auto              scene      = loader.read_scene_from_file(scene_path + "vokselia.gltf");
 
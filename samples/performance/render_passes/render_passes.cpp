@@ -113,6 +113,8 @@ bool RenderPassesSample::prepare(vkb::Platform &platform)
 	                      vkb::StatIndex::gpu_ext_read_bytes,
 	                      vkb::StatIndex::gpu_ext_write_bytes});
 
+	// Sponza is decoded once, later runs read its images and geometry from the scene cache
+	set_scene_cache_enable(true);
 	load_scene("scenes/sponza/Sponza01.gltf");
 
 	auto &camera_node = vkb::add_free_camera(*scene, "main_camera", get_render_context().get_surface_extent());
@@ -0,0 +1,141 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "common/logging.h"
+#include "timer.h"
+
+namespace vkbbench
+{
+Runner::Runner(const Options &options) :
+    options{options}
+{
+}
+
+bool Runner::is_enabled(const std::string &name) const
+{
+	return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+void Runner::run(const std::string &name, uint64_t items, const std::function<uint64_t()> &iteration)
+{
+	if (!is_enabled(name))
+	{
+		return;
+	}
+
+	vkb::Timer timer;
+
+	// Find how many iterations last the minimum sample time, which also warms the caches up
+	uint64_t iterations = 1;
+	while (true)
+	{
+		timer.start();
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			sink += iteration();
+		}
+		auto elapsed = timer.stop();
+
+		if (elapsed >= options.min_sample_time || iterations >= (1ull << 32))
+		{
+			break;
+		}
+
+		// Aim a little above the minimum, so that the next attempt is likely to be the last
+		auto estimate = elapsed > 0.0 ? static_cast<uint64_t>(iterations * options.min_sample_time * 1.2 / elapsed) : 0;
+		iterations    = std::max(iterations * 2, std::min(estimate, iterations * 100));
+	}
+
+	std::vector<double> times;
+	times.reserve(options.samples);
+
+	for (uint32_t sample = 0; sample < options.samples; sample++)
+	{
+		timer.start();
+		for (uint64_t i = 0; i < iterations; i++)
+		{
+			sink += iteration();
+		}
+		times.push_back(timer.stop<vkb::Timer::Nanoseconds>() / static_cast<double>(iterations));
+	}
+
+	std::sort(times.begin(), times.end());
+
+	auto count  = static_cast<double>(times.size());
+	auto median = times.size() % 2 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2.0;
+	auto mean   = std::accumulate(times.begin(), times.end(), 0.0) / count;
+
+	double variance = 0.0;
+	for (auto time : times)
+	{
+		variance += (time - mean) * (time - mean);
+	}
+	auto stddev = times.size() > 1 ? std::sqrt(variance / (count - 1.0)) : 0.0;
+
+	nlohmann::json result;
+	result["name"]             = name;
+	result["iterations"]       = iterations;
+	result["samples"]          = times.size();
+	result["items"]            = items;
+	result["median_ns"]        = median;
+	result["mean_ns"]          = mean;
+	result["stddev_ns"]        = stddev;
+	result["min_ns"]           = times.front();
+	result["max_ns"]           = times.back();
+	result["items_per_second"] = median > 0.0 ? static_cast<double>(items) * 1e9 / median : 0.0;
+
+	results.push_back(result);
+
+	LOGI("{:<40} {:>14.1f} ns {:>8.1f}% {:>14.0f} items/s", name, median, mean > 0.0 ? 100.0 * stddev / mean : 0.0, result["items_per_second"].get<double>());
+}
+
+void Runner::skip(const std::string &name, const std::string &reason)
+{
+	if (!is_enabled(name))
+	{
+		return;
+	}
+
+	results.push_back({{"name", name}, {"skipped", reason}});
+
+	LOGW("{:<40} skipped: {}", name, reason);
+}
+
+nlohmann::json Runner::get_results() const
+{
+	nlohmann::json json;
+
+	json["seed"]                 = SEED;
+	json["samples"]              = options.samples;
+	json["min_sample_time"]      = options.min_sample_time;
+	json["hardware_concurrency"] = std::thread::hardware_concurrency();
+	json["benchmarks"]           = results;
+
+	// Keeps the results of the iterations alive
+	json["checksum"] = sink;
+
+	return json;
+}
+}        // namespace vkbbench
@@ -0,0 +1,113 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+namespace vkbbench
+{
+/// Seed of the random generators of the benchmarks, so that every run measures the same data
+const uint32_t SEED = 42;
+
+template <typename T>
+inline const T &pick(std::mt19937 &rng, const std::vector<T> &values)
+{
+	std::uniform_int_distribution<size_t> distribution{0, values.size() - 1};
+	return values[distribution(rng)];
+}
+
+inline uint32_t random_u32(std::mt19937 &rng, uint32_t min, uint32_t max)
+{
+	std::uniform_int_distribution<uint32_t> distribution{min, max};
+	return distribution(rng);
+}
+
+struct Options
+{
+	/// Only the benchmarks whose name contains it are run
+	std::string filter;
+
+	/// The number of samples taken of each benchmark
+	uint32_t samples{15};
+
+	/// The minimum duration of a sample in seconds, iterations are repeated until a sample lasts as long
+	double min_sample_time{0.02};
+};
+
+/**
+ * @brief Measures the benchmarks and collects their results
+ *
+ * A benchmark is a function running one iteration of the measured code. It is repeated until a sample lasts the
+ * minimum sample time, and several samples are taken so that their median is stable against the noise of the host.
+ * The values the function returns are accumulated, so that the compiler cannot optimize the measured code away.
+ */
+class Runner
+{
+  public:
+	explicit Runner(const Options &options);
+
+	/**
+	 * @return True if the benchmark is selected by the filter
+	 */
+	bool is_enabled(const std::string &name) const;
+
+	/**
+	 * @brief Measures a benchmark
+	 * @param name The name of the benchmark
+	 * @param items The number of items an iteration processes, to report a throughput
+	 * @param iteration Runs one iteration, and returns a value depending on its result
+	 */
+	void run(const std::string &name, uint64_t items, const std::function<uint64_t()> &iteration);
+
+	/**
+	 * @brief Records that a benchmark could not run
+	 */
+	void skip(const std::string &name, const std::string &reason);
+
+	/**
+	 * @return The results, and the options they were measured with
+	 */
+	nlohmann::json get_results() const;
+
+  private:
+	Options options;
+
+	nlohmann::json results = nlohmann::json::array();
+
+	uint64_t sink{0};
+};
+
+/**
+ * @brief Runs the benchmarks of the framework which only need the CPU
+ *        The states which refer to Vulkan objects are built from stand-in handles, so they run without a Vulkan implementation.
+ */
+void run_cpu_benchmarks(Runner &runner);
+
+/**
+ * @brief Runs the benchmarks of the framework which create Vulkan objects, such as the resource cache lookups
+ *        They are created on a headless device, a software implementation is enough as only the CPU side is measured.
+ *        The benchmarks are skipped if there is no Vulkan implementation.
+ */
+void run_device_benchmarks(Runner &runner);
+}        // namespace vkbbench
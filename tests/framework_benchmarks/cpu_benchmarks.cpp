@@ -0,0 +1,494 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark.h"
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/error.h"
+
+VKBP_DISABLE_WARNINGS()
+#include "common/glm_common.h"
+VKBP_ENABLE_WARNINGS()
+
+#include "common/helpers.h"
+#include "common/resource_caching.h"
+#include "core/buffer.h"
+#include "core/image_view.h"
+#include "core/sampler.h"
+#include "gltf_loader_detail.h"
+#include "rendering/pipeline_state.h"
+#include "resource_binding_state.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/image/astc.h"
+#include "scene_graph/components/transform.h"
+#include "scene_graph/node.h"
+#include "scene_graph/scripts/animation.h"
+
+namespace vkbbench
+{
+namespace
+{
+inline uint64_t to_bits(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+/**
+ * @brief A non null handle, which only stands in for a Vulkan object to be hashed and compared
+ */
+template <typename THandle>
+inline THandle fake_handle(uint64_t value)
+{
+	// Non-dispatchable handles are either pointers or 64 bit integers
+	THandle handle{};
+	std::memcpy(&handle, &value, sizeof(handle));
+	return handle;
+}
+
+inline std::vector<uint8_t> random_bytes(std::mt19937 &rng, size_t size)
+{
+	std::uniform_int_distribution<uint32_t> distribution{0, 255};
+
+	std::vector<uint8_t> bytes(size);
+	for (auto &byte : bytes)
+	{
+		byte = static_cast<uint8_t>(distribution(rng));
+	}
+
+	return bytes;
+}
+
+/**
+ * @brief A forest of chains of nodes, so that the world matrices of the leaves go through deep hierarchies
+ */
+struct Hierarchy
+{
+	Hierarchy(std::mt19937 &rng, size_t chain_count, size_t depth)
+	{
+		std::uniform_real_distribution<float> distribution{-1.0f, 1.0f};
+
+		nodes.push_back(std::make_unique<vkb::sg::Node>(0, "root"));
+
+		for (size_t chain = 0; chain < chain_count; chain++)
+		{
+			auto *parent = nodes.front().get();
+
+			for (size_t level = 0; level < depth; level++)
+			{
+				auto node = std::make_unique<vkb::sg::Node>(nodes.size(), "node");
+
+				auto &transform = node->get_transform();
+				transform.set_translation({distribution(rng), distribution(rng), distribution(rng)});
+				transform.set_rotation(glm::normalize(glm::quat{distribution(rng), distribution(rng), distribution(rng), distribution(rng)}));
+				transform.set_scale(glm::vec3{1.0f + 0.1f * distribution(rng)});
+
+				node->set_parent(*parent);
+				parent->add_child(*node);
+
+				parent = node.get();
+				nodes.push_back(std::move(node));
+			}
+
+			leaves.push_back(parent);
+		}
+	}
+
+	std::vector<std::unique_ptr<vkb::sg::Node>> nodes;
+
+	std::vector<vkb::sg::Node *> leaves;
+};
+
+void benchmark_world_matrix(Runner &runner)
+{
+	std::mt19937 rng{SEED};
+	Hierarchy    hierarchy{rng, 16, 64};
+
+	// Every node is up to date, the matrices are read from the transforms
+	runner.run("transform_world_matrix_cached", hierarchy.nodes.size(), [&]() {
+		float sum = 0.0f;
+		for (auto &node : hierarchy.nodes)
+		{
+			sum += node->get_transform().get_world_matrix()[3][0];
+		}
+		return to_bits(sum);
+	});
+
+	// Every node moved, as in an animated skeleton, the leaves update their chains recursively
+	runner.run("transform_world_matrix_deep", hierarchy.nodes.size(), [&]() {
+		for (auto &node : hierarchy.nodes)
+		{
+			auto &transform = node->get_transform();
+			transform.set_translation(transform.get_translation());
+		}
+
+		float sum = 0.0f;
+		for (auto *leaf : hierarchy.leaves)
+		{
+			sum += leaf->get_transform().get_world_matrix()[3][0];
+		}
+		return to_bits(sum);
+	});
+}
+
+void benchmark_animation(Runner &runner)
+{
+	const size_t node_count     = 256;
+	const size_t keyframe_count = 64;
+
+	std::mt19937                          rng{SEED};
+	std::uniform_real_distribution<float> distribution{-1.0f, 1.0f};
+
+	std::vector<std::unique_ptr<vkb::sg::Node>> nodes;
+	vkb::sg::Animation                          animation{"benchmark"};
+
+	const vkb::sg::AnimationType   types[]   = {vkb::sg::AnimationType::Linear, vkb::sg::AnimationType::Step, vkb::sg::AnimationType::CubicSpline};
+	const vkb::sg::AnimationTarget targets[] = {vkb::sg::AnimationTarget::Translation, vkb::sg::AnimationTarget::Rotation, vkb::sg::AnimationTarget::Scale};
+
+	for (size_t i = 0; i < node_count; i++)
+	{
+		nodes.push_back(std::make_unique<vkb::sg::Node>(i, "node"));
+
+		for (size_t t = 0; t < 3; t++)
+		{
+			vkb::sg::AnimationSampler sampler;
+			sampler.type = types[(i + t) % 3];
+
+			for (size_t keyframe = 0; keyframe < keyframe_count; keyframe++)
+			{
+				sampler.inputs.push_back(static_cast<float>(keyframe) / 30.0f);
+			}
+
+			// Cubic splines have an in tangent, a value and an out tangent per keyframe
+			auto output_count = sampler.type == vkb::sg::AnimationType::CubicSpline ? keyframe_count * 3 : keyframe_count;
+			for (size_t output = 0; output < output_count; output++)
+			{
+				glm::vec4 value{distribution(rng), distribution(rng), distribution(rng), distribution(rng)};
+				sampler.outputs.push_back(targets[t] == vkb::sg::AnimationTarget::Rotation ? glm::normalize(value) : value);
+			}
+
+			animation.update_times(sampler.inputs.front(), sampler.inputs.back());
+			animation.add_channel(*nodes.back(), targets[t], sampler);
+		}
+	}
+
+	runner.run("animation_update", node_count * 3, [&]() {
+		animation.update(1.0f / 60.0f);
+		return to_bits(nodes.front()->get_transform().get_translation().x);
+	});
+}
+
+/**
+ * @brief Appends data to the buffer of a model, with an accessor reading it
+ * @return The index of the accessor
+ */
+inline int add_accessor(tinygltf::Model &model, const std::vector<uint8_t> &data, size_t byte_stride, size_t count, int component_type, int type)
+{
+	auto &buffer = model.buffers.front();
+
+	tinygltf::BufferView buffer_view;
+	buffer_view.buffer     = 0;
+	buffer_view.byteOffset = buffer.data.size();
+	buffer_view.byteLength = data.size();
+	buffer_view.byteStride = byte_stride;
+	model.bufferViews.push_back(buffer_view);
+
+	buffer.data.insert(buffer.data.end(), data.begin(), data.end());
+
+	tinygltf::Accessor accessor;
+	accessor.bufferView    = static_cast<int>(model.bufferViews.size() - 1);
+	accessor.componentType = component_type;
+	accessor.count         = count;
+	accessor.type          = type;
+	model.accessors.push_back(accessor);
+
+	return static_cast<int>(model.accessors.size() - 1);
+}
+
+template <typename T>
+std::vector<uint8_t> random_indices(std::mt19937 &rng, size_t count, uint32_t vertex_count)
+{
+	std::uniform_int_distribution<uint32_t> distribution{0, vertex_count - 1};
+
+	std::vector<uint8_t> bytes(count * sizeof(T));
+	for (size_t i = 0; i < count; i++)
+	{
+		auto index = static_cast<T>(distribution(rng));
+		std::memcpy(bytes.data() + i * sizeof(T), &index, sizeof(T));
+	}
+
+	return bytes;
+}
+
+void benchmark_gltf_accessors(Runner &runner)
+{
+	const uint32_t vertex_count = 65536;
+	const uint32_t index_count  = vertex_count * 6;
+
+	std::mt19937 rng{SEED};
+
+	tinygltf::Model model;
+	model.buffers.resize(1);
+
+	// Tightly packed positions, and normals and texture coordinates interleaved in a single buffer view
+	auto positions = add_accessor(model, random_bytes(rng, vertex_count * 12), 0, vertex_count, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+	auto normals   = add_accessor(model, random_bytes(rng, vertex_count * 20), 20, vertex_count, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3);
+
+	tinygltf::Accessor texcoords_accessor = model.accessors[normals];
+	texcoords_accessor.byteOffset         = 12;
+	texcoords_accessor.type               = TINYGLTF_TYPE_VEC2;
+	model.accessors.push_back(texcoords_accessor);
+	auto texcoords = static_cast<int>(model.accessors.size() - 1);
+
+	// A primitive with each index type, 8-bit indices are widened to 16 bits
+	std::vector<tinygltf::Primitive> primitives(3);
+	for (auto &primitive : primitives)
+	{
+		primitive.attributes = {{"POSITION", positions}, {"NORMAL", normals}, {"TEXCOORD_0", texcoords}};
+	}
+
+	primitives[0].indices = add_accessor(model, random_indices<uint32_t>(rng, index_count, vertex_count), 0, index_count, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR);
+	primitives[1].indices = add_accessor(model, random_indices<uint16_t>(rng, index_count, vertex_count), 0, index_count, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_SCALAR);
+	primitives[2].indices = add_accessor(model, random_indices<uint8_t>(rng, index_count, 256), 0, index_count, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_SCALAR);
+
+	runner.run("gltf_accessor_conversion", vertex_count * primitives.size(), [&]() {
+		uint64_t size = 0;
+		for (auto &primitive : primitives)
+		{
+			auto data = vkb::detail::extract_primitive_data(model, primitive);
+
+			size += data.index_data.size();
+			for (auto &attribute : data.attributes)
+			{
+				size += attribute.data.size();
+			}
+		}
+		return size;
+	});
+}
+
+void benchmark_generate_mipmaps(Runner &runner)
+{
+	const uint32_t size = 1024;
+
+	std::mt19937 rng{SEED};
+	auto         texels = random_bytes(rng, size * size * 4);
+
+	// The image is copied, as its mip chain can only be generated once
+	runner.run("image_generate_mipmaps", size * size, [&]() {
+		std::vector<vkb::sg::Mipmap> mipmaps(1);
+		mipmaps[0].extent = {size, size, 1};
+
+		vkb::sg::Image image{"benchmark", std::vector<uint8_t>{texels}, std::move(mipmaps)};
+		image.generate_mipmaps();
+
+		return image.get_data().back() + image.get_mipmaps().size();
+	});
+}
+
+void benchmark_astc_decode(Runner &runner)
+{
+	const uint32_t size  = 512;
+	const uint8_t  block = 6;
+
+	auto blocks = (size + block - 1) / block;
+
+	std::mt19937 rng{SEED};
+
+	// An ASTC file header: the magic number, the block size, and the extent on 24 bits per dimension
+	std::vector<uint8_t> file = {0x13, 0xAB, 0xA1, 0x5C,
+	                             block, block, 1,
+	                             size & 0xFF, (size >> 8) & 0xFF, (size >> 16) & 0xFF,
+	                             size & 0xFF, (size >> 8) & 0xFF, (size >> 16) & 0xFF,
+	                             1, 0, 0};
+
+	// Random blocks use every block mode, including illegal encodings which decode to the error color
+	auto data = random_bytes(rng, blocks * blocks * 16);
+	file.insert(file.end(), data.begin(), data.end());
+
+	runner.run("astc_decode", size * size, [&]() {
+		vkb::sg::Astc astc{"benchmark", file.data(), file.size()};
+		return astc.get_data().size();
+	});
+}
+
+void benchmark_pipeline_state_hash(Runner &runner)
+{
+	std::mt19937 rng{SEED};
+
+	const std::vector<VkFormat>            attribute_formats = {VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_R16G16B16A16_SFLOAT};
+	const std::vector<VkPrimitiveTopology> topologies        = {VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP, VK_PRIMITIVE_TOPOLOGY_LINE_LIST};
+	const std::vector<VkCullModeFlags>     cull_modes        = {VK_CULL_MODE_NONE, VK_CULL_MODE_BACK_BIT, VK_CULL_MODE_FRONT_BIT};
+	const std::vector<VkCompareOp>         compare_ops       = {VK_COMPARE_OP_GREATER, VK_COMPARE_OP_LESS, VK_COMPARE_OP_EQUAL};
+
+	// The states of the pipelines of a scene, which differ in their vertex layouts, blending and a few fixed function states.
+	// The layout and the render pass need a device, they are left out as they only add a few handles to the hash.
+	std::vector<vkb::PipelineState> pipeline_states(256);
+	for (auto &pipeline_state : pipeline_states)
+	{
+		pipeline_state.set_specialization_constant(0, vkb::to_bytes(random_u32(rng, 0, 3)));
+
+		vkb::VertexInputState vertex_input_state;
+		vertex_input_state.bindings = {{0, 32, VK_VERTEX_INPUT_RATE_VERTEX}, {1, 16, VK_VERTEX_INPUT_RATE_INSTANCE}};
+
+		auto attribute_count = random_u32(rng, 1, 6);
+		for (uint32_t location = 0; location < attribute_count; location++)
+		{
+			vertex_input_state.attributes.push_back({location, location % 2, pick(rng, attribute_formats), random_u32(rng, 0, 3) * 4});
+		}
+		pipeline_state.set_vertex_input_state(vertex_input_state);
+
+		vkb::InputAssemblyState input_assembly_state;
+		input_assembly_state.topology = pick(rng, topologies);
+		pipeline_state.set_input_assembly_state(input_assembly_state);
+
+		vkb::RasterizationState rasterization_state;
+		rasterization_state.cull_mode = pick(rng, cull_modes);
+		pipeline_state.set_rasterization_state(rasterization_state);
+
+		vkb::DepthStencilState depth_stencil_state;
+		depth_stencil_state.depth_compare_op   = pick(rng, compare_ops);
+		depth_stencil_state.depth_write_enable = random_u32(rng, 0, 1);
+		pipeline_state.set_depth_stencil_state(depth_stencil_state);
+
+		vkb::ColorBlendState color_blend_state;
+		color_blend_state.attachments.resize(random_u32(rng, 1, 4));
+		for (auto &attachment : color_blend_state.attachments)
+		{
+			attachment.blend_enable = random_u32(rng, 0, 1);
+		}
+		pipeline_state.set_color_blend_state(color_blend_state);
+	}
+
+	runner.run("pipeline_state_hash", pipeline_states.size(), [&]() {
+		std::hash<vkb::PipelineState> hasher;
+
+		uint64_t result = 0;
+		for (auto &pipeline_state : pipeline_states)
+		{
+			result ^= hasher(pipeline_state);
+		}
+		return result;
+	});
+}
+
+void benchmark_resource_binding_state(Runner &runner)
+{
+	std::mt19937 rng{SEED};
+
+	// The binding state only reads the handles of the resources, so stand-ins without a device are enough
+	std::vector<std::unique_ptr<vkb::core::Buffer>> buffers;
+	for (uint64_t i = 0; i < 16; i++)
+	{
+		buffers.push_back(std::make_unique<vkb::core::Buffer>(fake_handle<VkBuffer>(i + 1), 256));
+	}
+
+	std::vector<std::unique_ptr<vkb::core::ImageView>> image_views;
+	for (uint64_t i = 0; i < 8; i++)
+	{
+		image_views.push_back(std::make_unique<vkb::core::ImageView>(fake_handle<VkImageView>(i + 1), VK_FORMAT_R8G8B8A8_UNORM));
+	}
+
+	vkb::core::Sampler sampler{fake_handle<VkSampler>(1)};
+
+	struct Binding
+	{
+		bool image;
+
+		uint32_t resource;
+
+		uint32_t set;
+
+		uint32_t binding;
+	};
+
+	// The bindings of the draws of a frame: the same global uniforms, the textures of a material, and per draw uniforms
+	std::vector<std::vector<Binding>> draws(256);
+	for (auto &draw : draws)
+	{
+		draw.push_back({false, 0, 0, 0});
+
+		for (uint32_t binding = 0; binding < 3; binding++)
+		{
+			draw.push_back({true, random_u32(rng, 0, static_cast<uint32_t>(image_views.size() - 1)), 1, binding});
+		}
+
+		draw.push_back({false, random_u32(rng, 1, static_cast<uint32_t>(buffers.size() - 1)), 2, 0});
+	}
+
+	vkb::ResourceBindingState resource_binding_state;
+
+	runner.run("resource_binding_state_update", draws.size(), [&]() {
+		resource_binding_state.reset();
+
+		size_t result = 0;
+		for (auto &draw : draws)
+		{
+			for (auto &binding : draw)
+			{
+				if (binding.image)
+				{
+					resource_binding_state.bind_image(*image_views[binding.resource], sampler, binding.set, binding.binding, 0);
+				}
+				else
+				{
+					resource_binding_state.bind_buffer(*buffers[binding.resource], 0, 256, binding.set, binding.binding, 0);
+				}
+			}
+
+			// What a command buffer does with the state before a draw, without writing the descriptor sets
+			if (resource_binding_state.is_dirty())
+			{
+				resource_binding_state.clear_dirty();
+
+				for (auto &resource_set_it : resource_binding_state.get_resource_sets())
+				{
+					if (!resource_set_it.second.is_dirty())
+					{
+						continue;
+					}
+
+					resource_binding_state.clear_dirty(resource_set_it.first);
+
+					for (auto &resource_binding : resource_set_it.second.get_resource_bindings())
+					{
+						vkb::hash_combine(result, resource_binding.hash);
+					}
+				}
+			}
+		}
+		return result;
+	});
+}
+}        // namespace
+
+void run_cpu_benchmarks(Runner &runner)
+{
+	benchmark_world_matrix(runner);
+	benchmark_animation(runner);
+	benchmark_gltf_accessors(runner);
+	benchmark_generate_mipmaps(runner);
+	benchmark_astc_decode(runner);
+	benchmark_pipeline_state_hash(runner);
+	benchmark_resource_binding_state(runner);
+}
+}        // namespace vkbbench
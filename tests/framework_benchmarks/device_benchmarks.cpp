@@ -0,0 +1,147 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/debug.h"
+#include "core/device.h"
+#include "core/instance.h"
+#include "resource_cache.h"
+
+namespace vkbbench
+{
+namespace
+{
+const char *RESOURCE_CACHE_LOOKUP = "resource_cache_render_pass_lookup";
+
+/**
+ * @brief The arguments of a render pass request
+ */
+struct RenderPassRequest
+{
+	std::vector<vkb::Attachment> attachments;
+
+	std::vector<vkb::LoadStoreInfo> load_store_infos;
+
+	std::vector<vkb::SubpassInfo> subpasses;
+};
+
+inline RenderPassRequest random_render_pass_request(std::mt19937 &rng)
+{
+	const std::vector<VkFormat> color_formats = {VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R16G16B16A16_SFLOAT, VK_FORMAT_R32_SFLOAT};
+
+	const std::vector<VkAttachmentLoadOp> load_ops = {VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_LOAD_OP_DONT_CARE};
+
+	const std::vector<VkAttachmentStoreOp> store_ops = {VK_ATTACHMENT_STORE_OP_STORE, VK_ATTACHMENT_STORE_OP_DONT_CARE};
+
+	RenderPassRequest request;
+
+	vkb::SubpassInfo subpass{};
+	subpass.debug_name = "benchmark";
+
+	// A few color attachments, followed by a depth attachment
+	auto color_count = random_u32(rng, 1, 4);
+	for (uint32_t i = 0; i < color_count; i++)
+	{
+		request.attachments.emplace_back(pick(rng, color_formats), VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+		subpass.output_attachments.push_back(i);
+	}
+	request.attachments.emplace_back(VK_FORMAT_D32_SFLOAT, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
+	for (size_t i = 0; i < request.attachments.size(); i++)
+	{
+		request.load_store_infos.push_back({pick(rng, load_ops), pick(rng, store_ops)});
+	}
+
+	request.subpasses.push_back(subpass);
+
+	return request;
+}
+
+void benchmark_resource_cache_lookup(Runner &runner, vkb::Device &device)
+{
+	std::mt19937 rng{SEED};
+
+	auto &resource_cache = device.get_resource_cache();
+
+	// The render passes are created once, the lookups only hit the cache
+	std::vector<RenderPassRequest> requests;
+	for (size_t i = 0; i < 64; i++)
+	{
+		requests.push_back(random_render_pass_request(rng));
+
+		auto &request = requests.back();
+		resource_cache.request_render_pass(request.attachments, request.load_store_infos, request.subpasses);
+	}
+
+	std::vector<uint32_t> lookups(1024);
+	for (auto &lookup : lookups)
+	{
+		lookup = random_u32(rng, 0, static_cast<uint32_t>(requests.size() - 1));
+	}
+
+	runner.run(RESOURCE_CACHE_LOOKUP, lookups.size(), [&]() {
+		uint64_t found = 0;
+		for (auto lookup : lookups)
+		{
+			auto &request     = requests[lookup];
+			auto &render_pass = resource_cache.request_render_pass(request.attachments, request.load_store_infos, request.subpasses);
+
+			found += render_pass.get_handle() != VK_NULL_HANDLE;
+		}
+		return found;
+	});
+}
+}        // namespace
+
+void run_device_benchmarks(Runner &runner)
+{
+	if (!runner.is_enabled(RESOURCE_CACHE_LOOKUP))
+	{
+		return;
+	}
+
+	std::unique_ptr<vkb::Instance> instance;
+	std::unique_ptr<vkb::Device>   device;
+
+	try
+	{
+		VkResult result = volkInitialize();
+		if (result != VK_SUCCESS)
+		{
+			throw vkb::VulkanException(result, "Failed to initialize volk.");
+		}
+
+		// Headless, so that no surface extension is needed
+		instance = std::make_unique<vkb::Instance>("framework_benchmarks", std::unordered_map<const char *, bool>{}, std::vector<const char *>{}, true);
+		device   = std::make_unique<vkb::Device>(instance->get_first_gpu(), VK_NULL_HANDLE, std::make_unique<vkb::DummyDebugUtils>());
+	}
+	catch (const std::exception &e)
+	{
+		runner.skip(RESOURCE_CACHE_LOOKUP, e.what());
+		return;
+	}
+
+	benchmark_resource_cache_lookup(runner, *device);
+
+	device->wait_idle();
+}
+}        // namespace vkbbench
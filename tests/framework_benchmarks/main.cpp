@@ -0,0 +1,101 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "benchmark.h"
+#include "common/logging.h"
+
+namespace
+{
+void print_usage()
+{
+	std::cout << "Usage: framework_benchmarks [options]\n"
+	             "  --filter <text>          Only run the benchmarks whose name contains the text\n"
+	             "  --samples <count>        Number of samples of each benchmark (default 15)\n"
+	             "  --min-sample-time <ms>   Minimum duration of a sample (default 20)\n"
+	             "  --output <file>          JSON file the results are written to (default framework_benchmarks.json)\n";
+}
+}        // namespace
+
+int main(int argc, char *argv[])
+{
+	vkbbench::Options options;
+	std::string       output{"framework_benchmarks.json"};
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg{argv[i]};
+
+		if (arg == "--help" || arg == "-h")
+		{
+			print_usage();
+			return EXIT_SUCCESS;
+		}
+
+		if (i + 1 >= argc)
+		{
+			print_usage();
+			return EXIT_FAILURE;
+		}
+
+		std::string value{argv[++i]};
+
+		if (arg == "--filter")
+		{
+			options.filter = value;
+		}
+		else if (arg == "--samples")
+		{
+			options.samples = std::max(1, std::atoi(value.c_str()));
+		}
+		else if (arg == "--min-sample-time")
+		{
+			options.min_sample_time = std::atof(value.c_str()) / 1000.0;
+		}
+		else if (arg == "--output")
+		{
+			output = value;
+		}
+		else
+		{
+			print_usage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	vkbbench::Runner runner{options};
+
+	vkbbench::run_cpu_benchmarks(runner);
+	vkbbench::run_device_benchmarks(runner);
+
+	std::ofstream file{output, std::ios::out | std::ios::trunc};
+	file << runner.get_results().dump(4);
+
+	if (!file)
+	{
+		LOGE("Failed to write the results to {}", output);
+		return EXIT_FAILURE;
+	}
+
+	LOGI("Results written to {}", output);
+	return EXIT_SUCCESS;
+}